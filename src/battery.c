@@ -17,6 +17,7 @@
 #include "common.h"
 #include "config/tx.h"
 #include "music.h"
+#include "extended_audio.h"
 
 void PAGE_Test();
 
@@ -35,7 +36,9 @@ u8 BATTERY_Check()
     }
     if ((warned & BATTERY_LOW) && ms >= next_battery_warning) {
 #if HAS_EXTENDED_AUDIO
+        AUDIO_SetPriority(AUDIO_PRIO_ALARM);
         MUSIC_PlayValue(MUSIC_BATT_ALARM, battery/10,VOICE_UNIT_VOLT,2);
+        AUDIO_SetPriority(AUDIO_PRIO_NORMAL);
 #else
         MUSIC_Play(MUSIC_BATT_ALARM);
 #endif
@@ -16,67 +16,111 @@
 #include "buttons.h"
 #include "autodimmer.h"
 
-static buttonAction_t *buttonHEAD = NULL;
+/* Registered actions live in a small table.  Each button bit has a mask of
+ * the table slots subscribed to it, so dispatch only looks at the actions
+ * for the buttons that changed.  Dispatch order is kept with a rank:
+ * BUTTON_PRIORITY actions go before all others (latest first), the rest
+ * after them in registration order.
+ */
+#define MAX_BUTTON_ACTIONS 16
+static buttonAction_t *actions[MAX_BUTTON_ACTIONS];
+static u16 subscribers[32];
+static s32 first_rank, last_rank;
 static buttonAction_t *buttonPressed = NULL;
-#define DEBOUNCE_WAIT_MS 80
+
+/* Each button has a counter which moves towards BUTTON_DEBOUNCE_SAMPLES
+ * while it reads as pressed and towards 0 while it reads as released.  The
+ * debounced state only flips when a counter reaches either end.  Changes are
+ * queued with the time of the sample, which may be taken in an interrupt
+ * (HAS_BUTTON_SCAN_ISR): BUTTON_Sample() is the only writer of queue_head and
+ * BUTTON_Handler() the only writer of queue_tail, so no locking is needed.
+ */
+#define BUTTON_QUEUE_SIZE 8
+struct button_event {
+    u32 buttons;
+    u32 ms;
+};
+static volatile struct button_event queue[BUTTON_QUEUE_SIZE];
+static volatile u8 queue_head, queue_tail;
+static u8 integrator[32];
+static u32 integrating;         // buttons with a non-zero counter
+static volatile u32 debounced;
 
 void exec_callbacks(u32, enum ButtonFlags);
 
+static int is_registered(buttonAction_t *action)
+{
+    // Actions may be unregistered without ever having been registered
+    return action->slot && action->slot <= MAX_BUTTON_ACTIONS && actions[action->slot - 1] == action;
+}
+
+static u16 subscribed_to(u32 buttons)
+{
+    u16 slots = 0;
+    for (int i = 0; buttons; i++, buttons >>= 1) {
+        if (buttons & 1)
+            slots |= subscribers[i];
+    }
+    return slots;
+}
+
+static void set_subscriber(u32 buttons, int slot, int set)
+{
+    for (int i = 0; buttons; i++, buttons >>= 1) {
+        if (buttons & 1) {
+            if (set)
+                subscribers[i] |= 1 << slot;
+            else
+                subscribers[i] &= ~(1 << slot);
+        }
+    }
+}
+
 void BUTTON_RegisterCallback(buttonAction_t *action, u32 button, unsigned flags,
                  unsigned (*callback)(u32 button, unsigned flags, void *data), void *data)
 {
-    buttonAction_t *ptr;
-    //Ensure 'action' is not already in the linked list
-    if (buttonHEAD == action) {
-        buttonHEAD = action->next;
-    } else if(buttonHEAD) {
-        for(ptr = buttonHEAD; ptr->next; ptr = ptr->next) {
-            if(ptr->next == action) {
-                ptr->next = ptr->next->next;
-                break;
-            }
-        }
+    int slot;
+    BUTTON_UnregisterCallback(action);
+    for (slot = 0; slot < MAX_BUTTON_ACTIONS; slot++) {
+        if (! actions[slot])
+            break;
+    }
+    if (slot == MAX_BUTTON_ACTIONS) {
+        printf("ERROR: Too many button actions\n");
+        action->slot = 0;
+        return;
     }
-    ptr = buttonHEAD;
     if (! (flags & BUTTON_PRIORITY)) {
-        while(ptr) {
-            if((ptr->button & button) && (ptr->flags & flags) && ! (ptr->flags & BUTTON_PRIORITY)) {
+        u16 others = subscribed_to(button);
+        for (int i = 0; others; i++, others >>= 1) {
+            if ((others & 1) && (actions[i]->flags & flags) && ! (actions[i]->flags & BUTTON_PRIORITY)) {
                 printf("WARNING: Button %08x with flags %d is already assigned\n", (unsigned int)button, flags);
-                //memset(action, 0, sizeof(buttonAction_t));
-            }
-            if (! ptr->next)
                 break;
-            ptr = ptr->next;
+            }
         }
-        if (ptr)
-            ptr->next = action;
-        else
-            buttonHEAD = action;
-        action->next = NULL;
+        action->rank = ++last_rank;
     } else {
-       action->next = buttonHEAD;
-       buttonHEAD = action;
+        action->rank = --first_rank;
     }
     action->button = button;
     action->flags = flags;
     action->callback = callback;
     action->data = data;
+    action->slot = slot + 1;
+    actions[slot] = action;
+    set_subscriber(button, slot, 1);
 }
 
 void BUTTON_UnregisterCallback(buttonAction_t *action)
 {
-    buttonAction_t *ptr = buttonHEAD;
-    if (buttonHEAD == action) {
-        buttonHEAD = action->next;
+    if (! is_registered(action))
         return;
-    }
-    while(ptr) {
-        if(ptr->next == action) {
-            ptr->next = action->next;
-            return;
-        }
-        ptr = ptr->next;
-    }
+    int slot = action->slot - 1;
+    set_subscriber(action->button, slot, 0);
+    actions[slot] = NULL;
+    action->slot = 0;
+    if (buttonPressed == action)
+        buttonPressed = NULL;
 }
 
 void print_buttons(u32 buttons)
@@ -89,27 +133,49 @@ void print_buttons(u32 buttons)
     printf("Buttons: %s\n",buttonstring);
 }
 static u8 interrupt_longpress = 0;
-void BUTTON_Handler()
+
+void BUTTON_Sample(u32 buttons, u32 ms)
+{
+    u32 state = debounced;
+    u32 check = buttons | integrating;
+    for (int i = 0; check; i++, check >>= 1) {
+        if (! (check & 1))
+            continue;
+        u32 mask = 1 << i;
+        if (buttons & mask) {
+            if (integrator[i] < BUTTON_DEBOUNCE_SAMPLES && ++integrator[i] == BUTTON_DEBOUNCE_SAMPLES)
+                state |= mask;
+        } else if (--integrator[i] == 0) {
+            state &= ~mask;
+        }
+        if (integrator[i])
+            integrating |= mask;
+        else
+            integrating &= ~mask;
+    }
+    if (state == debounced)
+        return;
+    debounced = state;
+    u8 head = queue_head;
+    u8 next = (head + 1) % BUTTON_QUEUE_SIZE;
+    if (next == queue_tail)
+        return;  // Full: BUTTON_Handler() catches up from 'debounced'
+    queue[head].buttons = state;
+    queue[head].ms = ms;
+    queue_head = next;
+}
+
+static void process_buttons(u32 buttons, u32 ms)
 {
     static u32 last_buttons = 0;
     static u32 last_buttons_pressed = 0;
 
     static u32 long_press_at = 0;
     static u8  longpress_release = 0;
-    static u32 last_button_time = 0;
-
-    u32 ms = CLOCK_getms();
-    //debounce
-    if (ms < last_button_time)
-        return;
-    u32 buttons = ScanButtons();
 
     u32 buttons_pressed=   buttons  & (~last_buttons);
     u32 buttons_released=(~buttons) &   last_buttons;
 
-    if (buttons != last_buttons)
-        last_button_time = ms + DEBOUNCE_WAIT_MS;
-
     if(buttons_pressed && !longpress_release) {
         //printf("pressed: %08d\n", buttons_pressed);
         AUTODIMMER_Check();
@@ -132,7 +198,7 @@ void BUTTON_Handler()
     }
 
     if(buttons && (buttons == last_buttons) && !interrupt_longpress) {
-        if(ms > long_press_at) {
+        if((s32)(ms - long_press_at) > 0) {
             //printf("long_press: %08d\n", buttons_released);
             exec_callbacks(last_buttons_pressed, BUTTON_LONGPRESS);
             longpress_release=1;
@@ -143,6 +209,27 @@ void BUTTON_Handler()
     last_buttons=buttons;    
 }
 
+void BUTTON_Handler()
+{
+    u32 ms = CLOCK_getms();
+    static u32 last_sample;
+    if (ms - last_sample >= BUTTON_SCAN_MSEC) {
+        last_sample = ms;
+#if HAS_BUTTON_SCAN_ISR
+        ButtonMatrix_Poll();  // The part of the scan that can't run in the SysTick
+#else
+        BUTTON_Sample(ScanButtons(), ms);
+#endif
+    }
+    while (queue_tail != queue_head) {
+        u8 tail = queue_tail;
+        process_buttons(queue[tail].buttons, queue[tail].ms);
+        queue_tail = (tail + 1) % BUTTON_QUEUE_SIZE;
+    }
+    // Repeats the current state for long presses, and recovers from a full queue
+    process_buttons(debounced, ms);
+}
+
 void BUTTON_InterruptLongPress()
 {
     //printf("interrupt \n");
@@ -150,9 +237,21 @@ void BUTTON_InterruptLongPress()
 }
 
 void exec_callbacks(u32 buttons, enum ButtonFlags flags) {
-    buttonAction_t *ptr = buttonHEAD;
+    u16 pending = subscribed_to(buttons);
 
-    while(ptr) {
+    while(pending) {
+        // Visit the subscribers in dispatch order
+        buttonAction_t *ptr = NULL;
+        int slot = 0;
+        for (int i = 0; i < MAX_BUTTON_ACTIONS; i++) {
+            if ((pending & (1 << i)) && actions[i] && (! ptr || actions[i]->rank < ptr->rank)) {
+                ptr = actions[i];
+                slot = i;
+            }
+        }
+        if (! ptr)
+            break;
+        pending &= ~(1 << slot);
         if ((ptr->button & buttons) && (ptr->flags & flags)) {
             if(!(flags & BUTTON_RELEASE) || buttonPressed == ptr) {
                 //We only send a release to the button that accepted a press
@@ -163,9 +262,7 @@ void exec_callbacks(u32 buttons, enum ButtonFlags flags) {
                 }
             }
         }
-        ptr = ptr->next;
     }
-
 }
 
 #define TESTNAME buttons
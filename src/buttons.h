@@ -4,9 +4,10 @@
 struct buttonAction {
     u32 button;
     u8 flags;
+    u8 slot;     // index + 1 in the table of registered actions
+    s32 rank;    // dispatch order, lowest first
     unsigned (*callback)(u32 button, unsigned flags, void *data);
     void *data;
-    struct buttonAction *next;
 };
 
 enum ButtonFlags {
@@ -20,9 +21,21 @@ enum ButtonFlags {
 
 typedef struct buttonAction buttonAction_t;
 
+/* Buttons are sampled every BUTTON_SCAN_MSEC, and a button must be seen in
+ * the same state for BUTTON_DEBOUNCE_SAMPLES more samples than in the other
+ * before it is reported as pressed or released
+ */
+#ifndef BUTTON_SCAN_MSEC
+    #define BUTTON_SCAN_MSEC 2
+#endif
+#ifndef BUTTON_DEBOUNCE_SAMPLES
+    #define BUTTON_DEBOUNCE_SAMPLES 4
+#endif
+
 void BUTTON_RegisterCallback(buttonAction_t *action, u32 button, unsigned flags,
                  unsigned (*callback)(u32 button, unsigned flags, void *data), void *data);
 void BUTTON_UnregisterCallback(buttonAction_t *action);
 void BUTTON_Handler();
+void BUTTON_Sample(u32 buttons, u32 ms);
 void BUTTON_InterruptLongPress();
 #endif
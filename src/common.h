@@ -23,6 +23,7 @@ extern char tempstring[TEMPSTRINGLENGTH];
 typedef int8_t s8;
 typedef int16_t s16;
 typedef int32_t s32;
+typedef int64_t s64;
 typedef uint8_t u8;
 typedef uint16_t u16;
 typedef uint32_t u32;
@@ -55,9 +56,15 @@ void CONFIG_EnableLanguage(int state);
 int CONFIG_IniParse(const char* filename,
          int (*handler)(void*, const char*, const char*, const char*),
          void* user);
+#ifndef CONFIG_WRITE_BUFFER
+    #define CONFIG_WRITE_BUFFER 512   // ini output collected before each filesystem write
+#endif
+s8 mapstrcasecmp(const char *s1, const char *s2);
 u8 CONFIG_IsModelChanged();
 u8 CONFIG_SaveModelIfNeeded();
 void CONFIG_SaveTxIfNeeded();
+void CONFIG_AutoSaveModel(int can_save);
+void CONFIG_AutoSaveTx();
 extern const char * const MODULE_NAME[TX_MODULE_LAST];
 
 /* LCD primitive functions */
@@ -73,6 +80,8 @@ void LCD_GetCharDimensions(u32 c, u16 *width, u16 *height);
 u8 LCD_SetFont(unsigned int idx);
 u8  LCD_GetFont();
 void LCD_SetFontColor(u16 color);
+#define FONT_TRANSPARENT 0xFFFFFFFF
+void LCD_SetFontBackground(u32 color);
     /* Graphics */
 void LCD_DrawCircle(u16 x0, u16 y0, u16 r, u16 color);
 void LCD_FillCircle(u16 x0, u16 y0, u16 r, u16 color);
@@ -91,6 +100,7 @@ void LCD_DrawWindowedImageFromFile(u16 x, u16 y, const char *file, s16 w, s16 h,
 void LCD_DrawImageFromFile(u16 x, u16 y, const char *file);
 u8 LCD_ImageIsTransparent(const char *file);
 u8 LCD_ImageDimensions(const char *file, u16 *w, u16 *h);
+u8 LCD_CacheImage(const char *file);
 void LCD_DrawUSBLogo(int lcd_width, int lcd_height);
 
 /* Music */
@@ -196,6 +206,9 @@ int INPUT_SelectAbbrevSource(int src, int dir);
 
 const char *INPUT_MapSourceName(unsigned idx, unsigned *val);
 const char *INPUT_ButtonName(unsigned src);
+int INPUT_FindSource(const char *name);
+int INPUT_FindAbbrevSource(const char *name);
+int INPUT_FindButton(const char *name);
 void INPUT_CheckChanges(void);
 
 /* Misc */
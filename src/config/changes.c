@@ -0,0 +1,77 @@
+/*
+ This project is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Deviation is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "changes.h"
+
+static unsigned num_sections(const struct config_changes *c)
+{
+    return CONFIG_SECTIONS(c->size);
+}
+
+static u32 section_crc(const struct config_changes *c, unsigned section)
+{
+    unsigned start = section * CONFIG_SECTION_SIZE;
+    unsigned len = c->size - start;
+    if (len > CONFIG_SECTION_SIZE)
+        len = CONFIG_SECTION_SIZE;
+    return Crc(c->data + start, len);
+}
+
+static int check_section(struct config_changes *c, unsigned section)
+{
+    u32 crc = section_crc(c, section);
+    if (crc == c->crc[section])
+        return 0;
+    c->crc[section] = crc;
+    c->dirty |= 1 << section;
+    c->quiet = 0;
+    return 1;
+}
+
+/* The struct now matches what is stored on disk */
+void CONFIG_ChangesReset(struct config_changes *c)
+{
+    for (unsigned i = 0; i < num_sections(c); i++)
+        c->crc[i] = section_crc(c, i);
+    c->dirty = 0;
+    c->quiet = 0;
+    c->age = 0;
+}
+
+/* Exact check of every section, for the places which save unconditionally */
+int CONFIG_ChangesPending(struct config_changes *c)
+{
+    for (unsigned i = 0; i < num_sections(c); i++)
+        check_section(c, i);
+    return c->dirty != 0;
+}
+
+/* Checks the next section only.  Returns 1 once the struct changed and has
+ * been stable since, or keeps changing for longer than CONFIG_SAVE_MAX_AGE scans
+ */
+int CONFIG_ScanChanges(struct config_changes *c)
+{
+    if (! check_section(c, c->next) && c->quiet < 255)
+        c->quiet++;
+    if (++c->next == num_sections(c))
+        c->next = 0;
+    if (! c->dirty)
+        return 0;
+    if (c->age < 255)
+        c->age++;
+    return (c->quiet >= num_sections(c) && c->quiet >= CONFIG_SAVE_DELAY)
+           || c->age >= CONFIG_SAVE_MAX_AGE;
+}
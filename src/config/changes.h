@@ -0,0 +1,30 @@
+#ifndef _CHANGES_H_
+#define _CHANGES_H_
+
+/* Change detection for the Model and Transmitter structs.
+ * The struct is split into CONFIG_SECTION_SIZE byte sections, each with its
+ * own CRC.  CONFIG_ScanChanges() only checks one section per call, so the
+ * periodic auto-save never CRCs the whole struct in a single tick, and it
+ * only reports the struct as ready to save once a full pass (and at least
+ * CONFIG_SAVE_DELAY scans) went by without further changes.
+ */
+#define CONFIG_SECTION_SIZE 512
+#define CONFIG_SAVE_DELAY   10   // scans without changes before saving
+#define CONFIG_SAVE_MAX_AGE 50   // scans after which a changing struct is saved anyway
+#define CONFIG_SECTIONS(size) (((size) + CONFIG_SECTION_SIZE - 1) / CONFIG_SECTION_SIZE)
+
+struct config_changes {
+    const u8 *data;
+    u32 *crc;        // CONFIG_SECTIONS(size) entries
+    u16 size;
+    u8 next;         // section checked by the next scan
+    u8 quiet;        // scans since the last detected change
+    u8 age;          // scans since the struct became dirty
+    u32 dirty;       // one bit per changed section
+};
+
+void CONFIG_ChangesReset(struct config_changes *c);
+int CONFIG_ChangesPending(struct config_changes *c);
+int CONFIG_ScanChanges(struct config_changes *c);
+
+#endif // _CHANGES_H_
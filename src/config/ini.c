@@ -13,129 +13,189 @@ http://code.google.com/p/inih/
 
 #include "ini.h"
 
-#define MAX_INI_LINE_LENGTH 200
 #define MAX_SECTION 50
 #define MAX_NAME 50
 
-extern int isspace(int c);
+/* The file is read INI_BUFFER_SIZE bytes at a time and each line is split
+   into section/name/value in place, in a single pass over its characters.
+   A line that doesn't fit in the buffer is handled in pieces, as fgets did.
+   Uses a fair bit of stack (use heap instead if you need to) */
+#ifndef INI_BUFFER_SIZE
+#define INI_BUFFER_SIZE 256
+#endif
 
-/* Strip whitespace chars off end of given string, in place. Return s. */
-static char* rstrip(char* s)
+static inline int is_space(char c)
 {
-    char* p = s + strlen(s);
-    while (p > s && isspace((unsigned char)(*--p)))
-        *p = '\0';
-    return s;
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
 }
 
-/* Return pointer to first non-whitespace char in given string. */
-static char* lskip(const char* s)
+/* Strip whitespace chars off end of [s, end), in place. Return s. */
+static char* rstrip(char* s, char* end)
 {
-    while (*s && isspace((unsigned char)(*s)))
-        s++;
-    return (char*)s;
+    while (end > s && is_space(end[-1]))
+        end--;
+    *end = '\0';
+    return s;
 }
 
-/* Return pointer to first char c or ';' comment in given string, or pointer to
-   null at end of string if neither found. ';' must be prefixed by a whitespace
-   character to register as a comment. */
-static char* find_char_or_comment(const char* s, char c)
+/* Return pointer to first char c or ';' comment in [s, end), or end if
+   neither found. ';' must be prefixed by a whitespace character to register
+   as a comment. */
+static char* find_char_or_comment(char* s, char* end, char c)
 {
     int was_whitespace = 0;
-    while (*s && *s != c && !(was_whitespace && *s == ';')) {
-        was_whitespace = isspace((unsigned char)(*s));
+    while (s < end && *s != c && !(was_whitespace && *s == ';')) {
+        was_whitespace = is_space(*s);
         s++;
     }
-    return (char*)s;
+    return s;
 }
 
-/* See documentation in header file. */
-int ini_parse_file(FILE* file,
-                   int (*handler)(void*, const char*, const char*,
-                                  const char*),
-                   void* user)
-{
-    /* Uses a fair bit of stack (use heap instead if you need to) */
-    char line[MAX_INI_LINE_LENGTH];
-    char section[MAX_SECTION] = "";
-    char prev_name[MAX_NAME] = "";
+struct ini_state {
+    int (*handler)(void*, const char*, const char*, const char*);
+    void* user;
+    char section[MAX_SECTION];
+#if INI_ALLOW_MULTILINE
+    char prev_name[MAX_NAME];
+#endif
+    int lineno;
+    int error;
+    int done;
+};
 
-    char* start;
-    char* end;
+/* Parse the line in [line, end).  *end may be overwritten */
+static void parse_line(struct ini_state* st, char* line, char* end)
+{
+    char* start = line;
+    char* sep;
     char* name;
     char* value;
-    int lineno = 0;
-    int error = 0;
-    int done = 0;
 
-    /* Scan through file line by line */
-    while (done != -1 && fgets(line, sizeof(line), file) != NULL) {
-        lineno++;
-
-        start = line;
+    st->lineno++;
 #if INI_ALLOW_BOM
-        if (lineno == 1 && (unsigned char)start[0] == 0xEF &&
-                           (unsigned char)start[1] == 0xBB &&
-                           (unsigned char)start[2] == 0xBF) {
-            start += 3;
-        }
+    if (st->lineno == 1 && end - start >= 3 && (unsigned char)start[0] == 0xEF &&
+                                               (unsigned char)start[1] == 0xBB &&
+                                               (unsigned char)start[2] == 0xBF) {
+        start += 3;
+    }
+#endif
+    while (start < end && is_space(*start))
+        start++;
+    if (start == end || *start == ';' || *start == '#') {
+        /* Per Python ConfigParser, allow '#' comments at start of line */
+        return;
+    }
+#if INI_ALLOW_MULTILINE
+    if (*st->prev_name && start > line) {
+        /* Non-black line with leading whitespace, treat as continuation
+           of previous name's value (as per Python ConfigParser). */
+        if (!st->handler(st->user, st->section, st->prev_name, rstrip(start, end)) && !st->error)
+            st->error = st->lineno;
+        return;
+    }
+#endif
+    if (*start == '[') {
+        /* A "[section]" line */
+        sep = find_char_or_comment(start + 1, end, ']');
+        if (sep < end && *sep == ']') {
+            *sep = '\0';
+            strlcpy(st->section, start + 1, sizeof(st->section));
+#if INI_ALLOW_MULTILINE
+            *st->prev_name = '\0';
 #endif
-        start = lskip(rstrip(start));
+        }
+        else if (!st->error) {
+            /* No ']' found on section line */
+            st->error = st->lineno;
+        }
+        return;
+    }
 
-        if (*start == ';' || *start == '#') {
-            /* Per Python ConfigParser, allow '#' comments at start of line */
+    /* Not a comment, must be a name[=:]value pair.  '=' wins over an
+       earlier ':' */
+    sep = NULL;
+    {
+        int was_whitespace = 0;
+        char* p;
+        for (p = start; p < end && *p != '=' && !(was_whitespace && *p == ';'); p++) {
+            if (*p == ':' && !sep)
+                sep = p;
+            was_whitespace = is_space(*p);
         }
+        if (p < end && *p == '=')
+            sep = p;
+    }
+    if (!sep) {
+        /* No '=' or ':' found on name[=:]value line */
+        if (!st->error)
+            st->error = st->lineno;
+        return;
+    }
+    name = rstrip(start, sep);
+    value = sep + 1;
+    while (value < end && is_space(*value))
+        value++;
+    rstrip(value, find_char_or_comment(value, end, '\0'));
+
+    /* Valid name[=:]value pair found, call handler */
 #if INI_ALLOW_MULTILINE
-        else if (*prev_name && *start && start > line) {
-            /* Non-black line with leading whitespace, treat as continuation
-               of previous name's value (as per Python ConfigParser). */
-            if (!handler(user, section, prev_name, start) && !error)
-                error = lineno;
-        }
+    strlcpy(st->prev_name, name, sizeof(st->prev_name));
 #endif
-        else if (*start == '[') {
-            /* A "[section]" line */
-            end = find_char_or_comment(start + 1, ']');
-            if (*end == ']') {
-                *end = '\0';
-                strlcpy(section, start + 1, sizeof(section));
-                *prev_name = '\0';
-            }
-            else if (!error) {
-                /* No ']' found on section line */
-                error = lineno;
-            }
-        }
-        else if (*start && *start != ';') {
-            /* Not a comment, must be a name[=:]value pair */
-            end = find_char_or_comment(start, '=');
-            if (*end != '=') {
-                end = find_char_or_comment(start, ':');
-            }
-            if (*end == '=' || *end == ':') {
-                *end = '\0';
-                name = rstrip(start);
-                value = lskip(end + 1);
-                end = find_char_or_comment(value, '\0');
-                if (*end == ';')
-                    *end = '\0';
-                rstrip(value);
-
-                /* Valid name[=:]value pair found, call handler */
-                strlcpy(prev_name, name, sizeof(prev_name));
-
-                done = handler(user, section, name, value);
-                if (done != 1 && !error)
-                    error = lineno;
+    st->done = st->handler(st->user, st->section, name, value);
+    if (st->done != 1 && !st->error)
+        st->error = st->lineno;
+}
+
+/* See documentation in header file. */
+int ini_parse_file(FILE* file,
+                   int (*handler)(void*, const char*, const char*,
+                                  const char*),
+                   void* user)
+{
+    char buf[INI_BUFFER_SIZE + 1];
+    struct ini_state st;
+    int len = 0;
+    int pos = 0;
+    int eof = 0;
+
+    st.handler = handler;
+    st.user = user;
+    st.section[0] = '\0';
+#if INI_ALLOW_MULTILINE
+    st.prev_name[0] = '\0';
+#endif
+    st.lineno = 0;
+    st.error = 0;
+    st.done = 0;
+
+    while (st.done != -1) {
+        char* line = buf + pos;
+        char* nl = memchr(line, '\n', len - pos);
+        if (!nl) {
+            if (!eof && pos) {
+                /* Move the partial line to the front and fill up the rest */
+                len -= pos;
+                memmove(buf, line, len);
+                pos = 0;
             }
-            else if (!error) {
-                /* No '=' or ':' found on name[=:]value line */
-                error = lineno;
+            if (!eof && len < INI_BUFFER_SIZE) {
+                int bytes = fread(buf + len, 1, INI_BUFFER_SIZE - len, file);
+                if (bytes <= 0)
+                    eof = 1;
+                else
+                    len += bytes;
+                continue;
             }
+            if (pos == len)
+                break;
+            /* Last line without a '\n', or a line longer than the buffer */
+            nl = buf + len;
         }
+        parse_line(&st, line, nl);
+        pos = nl - buf + (nl < buf + len);
     }
 
-    return error;
+    return st.error;
 }
 
 /* See documentation in header file. */
@@ -153,3 +213,6 @@ int ini_parse(const char* filename,
     fclose(file);
     return error;
 }
+
+#define TESTNAME ini
+#include <tests.h>
@@ -19,14 +19,16 @@
 #include "tx.h"
 #include "music.h"
 #include "extended_audio.h"
+#include "changes.h"
 
 #include <stdlib.h>
 #include <string.h>
 extern const u8 EATRG0[PROTO_MAP_LEN];
 
 struct Model Model;
-/*set this to write all model data even if it is the same as the default */
-static u32 crc32;
+static u32 section_crc[CONFIG_SECTIONS(sizeof(Model))];
+static struct config_changes changes = {(const u8 *)&Model, section_crc, sizeof(Model), 0, 0, 0, 0};
+ctassert(CONFIG_SECTIONS(sizeof(Model)) <= 32, model_too_large_for_change_tracking);
 
 const char * const MODEL_TYPE_VAL[MODELTYPE_LAST] = { "heli", "plane", "multi" };
 
@@ -267,50 +269,27 @@ s8 mapstrcasecmp(const char *s1, const char *s2)
 }
 static u8 get_source(const char *section, const char *value)
 {
-    unsigned i;
-    unsigned val;
     const char *ptr = (value[0] == '!') ? value + 1 : value;
-    const char *tmp;
-    char cmp[10];
-    for (i = 0; i <= NUM_SOURCES; i++) {
-        if(mapstrcasecmp(INPUT_SourceNameReal(cmp, i), ptr) == 0) {
-            #if defined(HAS_SWITCHES_NOSTOCK) && HAS_SWITCHES_NOSTOCK
-            #define SWITCH_NOSTOCK ((1 << INP_HOLD0) | (1 << INP_HOLD1) | \
-                                    (1 << INP_FMOD0) | (1 << INP_FMOD1))
-            if ((Transmitter.ignore_src & SWITCH_NOSTOCK) == SWITCH_NOSTOCK) {
-                if(mapstrcasecmp("FMODE0", ptr) == 0 ||
-                   mapstrcasecmp("FMODE1", ptr) == 0 ||
-                   mapstrcasecmp("HOLD0", ptr) == 0 ||
-                   mapstrcasecmp("HOLD1", ptr) == 0)
-                    break;
-            }
-            #endif //HAS_SWITCHES_NOSTOCK
-            return ((ptr == value) ? 0 : 0x80) | i;
-        }
-    }
-    for (i = 0; i < 4; i++) {
-        if(mapstrcasecmp(tx_stick_names[i], ptr) == 0) {
-            return ((ptr == value) ? 0 : 0x80) | (i + 1);
-        }
-    }
-    i = 0;
-    while((tmp = INPUT_MapSourceName(i++, &val))) {
-        if(mapstrcasecmp(tmp, ptr) == 0) {
-            return ((ptr == value) ? 0 : 0x80) | val;
-        }
-    }
+    int src = INPUT_FindSource(ptr);
+    #if defined(HAS_SWITCHES_NOSTOCK) && HAS_SWITCHES_NOSTOCK
+    #define SWITCH_NOSTOCK ((1 << INP_HOLD0) | (1 << INP_HOLD1) | \
+                            (1 << INP_FMOD0) | (1 << INP_FMOD1))
+    if ((Transmitter.ignore_src & SWITCH_NOSTOCK) == SWITCH_NOSTOCK) {
+        if (src == INP_FMOD0 || src == INP_FMOD1 || src == INP_HOLD0 || src == INP_HOLD1)
+            src = -1;
+    }
+    #endif //HAS_SWITCHES_NOSTOCK
+    if (src >= 0)
+        return ((ptr == value) ? 0 : 0x80) | src;
     printf("%s: Could not parse Source %s\n", section, value);
     return 0;
 }
 
 static u8 get_button(const char *section, const char *value)
 {
-    u8 i;
-    for (i = 0; i <= NUM_TX_BUTTONS; i++) {
-        if(strcasecmp(INPUT_ButtonName(i), value) == 0) {
-            return i;
-        }
-    }
+    int button = INPUT_FindButton(value);
+    if (button >= 0)
+        return button;
     printf("%s: Could not parse Button %s\n", section, value);
     return 0;
 }
@@ -552,13 +531,9 @@ static int layout_ini_handler(void* user, const char* section, const char* name,
         {
             if(count)
                 return 1;
-            for (int j = 0; j <= NUM_SOURCES; j++) {
-                char cmp[10];
-                if(mapstrcasecmp(INPUT_SourceNameAbbrevSwitchReal(cmp, j), ptr+1) == 0) {
-                    data[5] = j;
-                    break;
-                }
-            }
+            int src = INPUT_FindAbbrevSource(ptr+1);
+            if (src >= 0)
+                data[5] = src;
             break;
         }
     }
@@ -889,13 +864,9 @@ int assign_int(void* ptr, const struct struct_map *map, int map_size)
         if(assign_int(&m->trims[idx], _sectrim, MAPSIZE(_sectrim)))
             return 1;
         if (MATCH_KEY(TRIM_SWITCH)) {
-            for (int i = 0; i <= NUM_SOURCES; i++) {
-                char cmp[10];
-                if(mapstrcasecmp(INPUT_SourceNameAbbrevSwitchReal(cmp, i), value) == 0) {
-                    m->trims[idx].sw = i;
-                    return 1;
-                }
-            }
+            int sw = INPUT_FindAbbrevSource(value);
+            if (sw >= 0)
+                m->trims[idx].sw = sw;
             return 1;
         }
         if (MATCH_KEY(TRIM_VALUE)) {
@@ -1233,6 +1204,7 @@ static void write_proto_opts(FILE *fh, struct Model *m)
 
 u8 CONFIG_WriteModel(u8 model_num) {
     char file[20];
+    char buf[CONFIG_WRITE_BUFFER];
     FILE *fh;
     u8 idx;
     struct Model *m = &Model;
@@ -1244,6 +1216,7 @@ u8 CONFIG_WriteModel(u8 model_num) {
         printf("Couldn't open file: %s\n", file);
         return 0;
     }
+    setvbuf(fh, buf, _IOFBF, sizeof(buf));
     CONFIG_EnableLanguage(0);
     fprintf(fh, "%s=%s\n", MODEL_NAME, m->name);
 #if HAS_PERMANENT_TIMER
@@ -1497,7 +1470,6 @@ static void clear_model(u8 full)
 }
 
 u8 CONFIG_ReadModel(u8 model_num) {
-    crc32 = 0;
     Transmitter.current_model = model_num;
     clear_model(1);
 
@@ -1516,7 +1488,7 @@ u8 CONFIG_ReadModel(u8 model_num) {
         RemapChannelsForProtocol(EATRG0);
     TIMER_Init();
     MIXER_RegisterTrimButtons();
-    crc32 = Crc(&Model, sizeof(Model));
+    CONFIG_ChangesReset(&changes);
     if(! Model.name[0])
         sprintf(Model.name, "Model%d", model_num);
     if (PPMin_Mode())
@@ -1531,19 +1503,26 @@ u8 CONFIG_ReadModel(u8 model_num) {
 }
 
 u8 CONFIG_IsModelChanged() {
-    u32 newCrc = Crc(&Model, sizeof(Model));
-    return (crc32 != newCrc);
+    return CONFIG_ChangesPending(&changes);
 }
 
 u8 CONFIG_SaveModelIfNeeded() {
     if (CONFIG_IsModelChanged()) {
-        crc32 = Crc(&Model, sizeof(Model));
         //printf("Saving model, page %d\n", PAGE_GetID());
         CONFIG_WriteModel(Transmitter.current_model);
+        CONFIG_ChangesReset(&changes);
     }
     return 1;
 }
 
+/* Like CONFIG_AutoSaveTx(), but the scan keeps running while the model is
+ * being edited so the save can happen as soon as editing is done */
+void CONFIG_AutoSaveModel(int can_save)
+{
+    if (CONFIG_ScanChanges(&changes) && can_save)
+        CONFIG_SaveModelIfNeeded();
+}
+
 void CONFIG_ResetModel()
 {
     u8 model_num = Transmitter.current_model;
@@ -19,13 +19,17 @@
 #include "tx.h"
 #include "rtc.h"
 #include "voice.h"
+#include "changes.h"
 
 #include <stdlib.h>
 #include <string.h>
 #include "autodimmer.h"
 
 struct Transmitter Transmitter;
-static u32 crc32;
+struct dsp_config InputDSP[INP_HAS_CALIBRATION];
+static u32 section_crc[CONFIG_SECTIONS(sizeof(Transmitter))];
+static struct config_changes changes = {(const u8 *)&Transmitter, section_crc, sizeof(Transmitter), 0, 0, 0, 0};
+ctassert(CONFIG_SECTIONS(sizeof(Transmitter)) <= 32, transmitter_too_large_for_change_tracking);
 
 const char CURRENT_MODEL[] = "current_model";
 
@@ -57,6 +61,11 @@ const char SECTION_CALIBRATE[] = "calibrate";
 const char CALIBRATE_MAX[] = "max";
 const char CALIBRATE_MIN[] = "min";
 const char CALIBRATE_ZERO[] = "zero";
+const char CALIBRATE_FILTER[] = "filter";
+static const char * const CALIBRATE_FILTER_VAL[DSP_FILTER_LAST] = { "none", "median", "iir" };
+const char CALIBRATE_SMOOTHING[] = "smoothing";
+const char CALIBRATE_DEADBAND[] = "deadband";
+const char CALIBRATE_SLEW[] = "slew";
 
 const char SECTION_TOUCH[] = "touch";
 const char TOUCH_XSCALE[] = "xscale";
@@ -185,6 +194,28 @@ static int ini_handler(void* user, const char* section, const char* name, const
             t->calibration[idx].zero = value_int;
             return 1;
         }
+        if (MATCH_KEY(CALIBRATE_FILTER)) {
+            for (unsigned i = 0; i < NUM_STR_ELEMS(CALIBRATE_FILTER_VAL); i++) {
+                if (MATCH_VALUE(CALIBRATE_FILTER_VAL[i])) {
+                    InputDSP[idx].filter = i;
+                    return 1;
+                }
+            }
+            printf("%s: Unknown filter: %s\n", section, value);
+            return 1;
+        }
+        if (MATCH_KEY(CALIBRATE_SMOOTHING)) {
+            InputDSP[idx].smoothing = value_int;
+            return 1;
+        }
+        if (MATCH_KEY(CALIBRATE_DEADBAND)) {
+            InputDSP[idx].deadband = value_int;
+            return 1;
+        }
+        if (MATCH_KEY(CALIBRATE_SLEW)) {
+            InputDSP[idx].slew = value_int;
+            return 1;
+        }
     }
     if (HAS_TOUCH) {
         if (MATCH_SECTION(SECTION_TOUCH)) {
@@ -253,6 +284,7 @@ static int ini_handler(void* user, const char* section, const char* name, const
 void CONFIG_WriteTx()
 {
     int i;
+    char buf[CONFIG_WRITE_BUFFER];
     FILE *fh;
     struct Transmitter *t = &Transmitter;
     fh = fopen("tx.ini", "w");
@@ -260,6 +292,7 @@ void CONFIG_WriteTx()
         printf("Couldn't open tx.ini\n");
         return;
     }
+    setvbuf(fh, buf, _IOFBF, sizeof(buf));
     CONFIG_EnableLanguage(0);
     fprintf(fh, "%s=%d\n", CURRENT_MODEL, Transmitter.current_model);
     fprintf(fh, "%s=%d\n", LANGUAGE, Transmitter.language);
@@ -286,6 +319,14 @@ void CONFIG_WriteTx()
         fprintf(fh, "  %s=%d\n", CALIBRATE_MAX, t->calibration[i].max);
         fprintf(fh, "  %s=%d\n", CALIBRATE_MIN, t->calibration[i].min);
         fprintf(fh, "  %s=%d\n", CALIBRATE_ZERO, t->calibration[i].zero);
+        if (InputDSP[i].filter && InputDSP[i].filter < DSP_FILTER_LAST)
+            fprintf(fh, "  %s=%s\n", CALIBRATE_FILTER, CALIBRATE_FILTER_VAL[InputDSP[i].filter]);
+        if (InputDSP[i].smoothing)
+            fprintf(fh, "  %s=%d\n", CALIBRATE_SMOOTHING, InputDSP[i].smoothing);
+        if (InputDSP[i].deadband)
+            fprintf(fh, "  %s=%d\n", CALIBRATE_DEADBAND, InputDSP[i].deadband);
+        if (InputDSP[i].slew)
+            fprintf(fh, "  %s=%d\n", CALIBRATE_SLEW, InputDSP[i].slew);
     }
     if (HAS_TOUCH) {
         fprintf(fh, "[%s]\n", SECTION_TOUCH);
@@ -314,6 +355,7 @@ void CONFIG_WriteTx()
 void CONFIG_LoadTx()
 {
     memset(&Transmitter, 0, sizeof(Transmitter));
+    memset(InputDSP, 0, sizeof(InputDSP));
     Transmitter.current_model = 1;
     Transmitter.music_shutdown = 0; // default to off
     Transmitter.mode = MODE_2;
@@ -348,7 +390,7 @@ void CONFIG_LoadTx()
     MCU_InitModules();
     CONFIG_LoadHardware();
     CONFIG_IniParse("tx.ini", ini_handler, (void *)&Transmitter);
-    crc32 = Crc(&Transmitter, sizeof(Transmitter));
+    CONFIG_ChangesReset(&changes);
 #if HAS_EXTENDED_AUDIO
     CONFIG_VoiceParse(MAX_VOICEMAP_ENTRIES);
 #endif
@@ -357,10 +399,17 @@ void CONFIG_LoadTx()
 
 void CONFIG_SaveTxIfNeeded()
 {
-    u32 newCrc = Crc(&Transmitter, sizeof(Transmitter));
-    if (crc32 == newCrc)
+    if (! CONFIG_ChangesPending(&changes))
         return;
-    crc32 = newCrc;
     //printf("Saving TX\n");
     CONFIG_WriteTx();
+    CONFIG_ChangesReset(&changes);
+}
+
+/* Called every LOW_PRIORITY tick: only a part of Transmitter is checked each
+ * time, and it is only saved once the changes have settled */
+void CONFIG_AutoSaveTx()
+{
+    if (CONFIG_ScanChanges(&changes))
+        CONFIG_SaveTxIfNeeded();
 }
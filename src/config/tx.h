@@ -5,6 +5,7 @@
 #include "autodimmer.h"
 #include "telemetry.h"
 #include "music.h"
+#include "dsp.h"
 
 #define DEFAULT_BATTERY_WARNING_INTERVAL 30
 #define MIN_BATTERY_WARNING_INTERVAL 0
@@ -97,6 +98,9 @@ struct Transmitter {
 };
 
 extern struct Transmitter Transmitter;
+/* Kept out of struct Transmitter, whose CRC some protocols use for their
+ * fixed id */
+extern struct dsp_config InputDSP[INP_HAS_CALIBRATION];
 #define MODULE_ENABLE Transmitter.module_enable
 
 void CONFIG_LoadTx();
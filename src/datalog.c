@@ -175,8 +175,70 @@ void _write_header() {
     dlog_pos += 3 + sizeof(Model.datalog.source);
 }
 
+/* Telemetry sources being logged keep a history, so that each record
+ * holds the average of the last TELEM_HIST_DECIMATE reports (one second
+ * at the full rate) rather than a single sample.
+ * Sources without a range (status flags) are always logged as is.
+ * Only the subscriptions made here are dropped again, other users of the
+ * history keep theirs.  If there aren't enough history slots for every
+ * logged source, or a source has no average yet, the whole record is
+ * written from the current values so a record never mixes the two. */
+static u32 dlog_subscribed[TELEM_UPDATE_SIZE];
+static u8 dlog_averaged;
+
+static int _is_logged_telemetry(int src)
+{
+    int idx = DLOG_TELEMETRY + src - 1;
+    return (Model.datalog.source[DATALOG_BYTE(idx)] & (1 << DATALOG_POS(idx)))
+           && TELEMETRY_GetMaxValue(src);
+}
+
+static void _subscribe_telemetry()
+{
+    dlog_averaged = 1;
+    for (int i = 1; i <= NUM_TELEM; i++) {
+        u32 bit = 1 << (i % 32);
+        if (dlog_subscribed[i / 32] & bit) {
+            TELEMETRY_HistoryUnsubscribe(i);
+            dlog_subscribed[i / 32] &= ~bit;
+        }
+        if (! _is_logged_telemetry(i))
+            continue;
+        if (TELEMETRY_HistorySubscribe(i) >= 0) {
+            dlog_subscribed[i / 32] |= bit;
+        } else {
+            printf("Datalog: no history slot for telemetry %d, logging current values\n", i);
+            dlog_averaged = 0;
+        }
+    }
+}
+
+static int _telemetry_averaged()
+{
+    s32 value;
+    if (! dlog_averaged)
+        return 0;
+    for (int i = 1; i <= NUM_TELEM; i++) {
+        if ((dlog_subscribed[i / 32] & (1 << (i % 32)))
+            && ! TELEMETRY_GetHistory(i, TELEM_HIST_1SEC, &value, 1))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static s32 _telemetry_value(int src, int averaged)
+{
+    s32 value;
+    if (averaged && TELEMETRY_GetHistory(src, TELEM_HIST_1SEC, &value, 1))
+        return value;
+    return TELEMETRY_GetValue(src);
+}
+
 void DATALOG_Write()
 {
+    int averaged = _telemetry_averaged();
     _write_8(0xff);
     for (int i = 0; i < DLOG_LAST; i++) {
         if(! (Model.datalog.source[DATALOG_BYTE(i)] & (1 << DATALOG_POS(i))))
@@ -204,7 +266,7 @@ void DATALOG_Write()
                 val = -128;
             _write_8(val);
         } else if(i >= DLOG_TELEMETRY) {
-            _write_16(TELEMETRY_GetValue(i - DLOG_TELEMETRY + 1));
+            _write_16(_telemetry_value(i - DLOG_TELEMETRY + 1, averaged));
         } else {
             _write_16(TIMER_GetValue(i) / 1000); //seconds
         }
@@ -231,6 +293,7 @@ void DATALOG_UpdateState()
     next_update = CLOCK_getms() + UPDATE_DELAY;
     data_size = DATALOG_GetSize(Model.datalog.source);
     need_header_update = 1;
+    _subscribe_telemetry();
 }
 
 void DATALOG_Reset()
@@ -262,6 +325,7 @@ void DATALOG_Init()
         dlog_size = ftell(fh);
         fseek(fh, pos, SEEK_SET);
         data_size = DATALOG_GetSize(Model.datalog.source);
+        _subscribe_telemetry();
         printf("num data: %d data size: %d\n", DLOG_LAST, DATALOG_GetSize(NULL));
         next_update = CLOCK_getms();
     }
@@ -0,0 +1,98 @@
+/*
+ This project is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Deviation is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "mixer.h"
+#include "dsp.h"
+#include <stdlib.h>
+
+#define TRAVEL_STEP ((CHAN_MAX_VALUE - CHAN_MIN_VALUE) / 1000)  // 0.1% of full travel
+
+void DSP_SetCalibration(struct dsp_calibration *cal, u16 min, u16 max, u16 zero)
+{
+    if (!zero) {
+        // If this input doesn't have a zero, calculate from max/min
+        zero = ((u32)max + min) / 2;
+    }
+    // Derate min and max by 1% to ensure we can get all the way to 100%
+    s32 pos = ((s32)max - zero) * 99 / 100;
+    s32 neg = ((s32)min - zero) * 99 / 100;
+    cal->zero = zero;
+    cal->pos_gain = pos ? CHAN_MAX_VALUE * 65536 / pos : 0;
+    cal->neg_gain = neg ? CHAN_MIN_VALUE * 65536 / neg : 0;
+}
+
+s32 DSP_Calibrate(const struct dsp_calibration *cal, s32 value)
+{
+    value -= cal->zero;
+    value = ((s64)value * (value >= 0 ? cal->pos_gain : cal->neg_gain)) >> 16;
+    // Bound output
+    if (value > CHAN_MAX_VALUE)
+        value = CHAN_MAX_VALUE;
+    if (value < CHAN_MIN_VALUE)
+        value = CHAN_MIN_VALUE;
+    return value;
+}
+
+static s32 median3(s32 a, s32 b, s32 c)
+{
+    if (a > b) {
+        s32 t = a; a = b; b = t;
+    }
+    if (b > c)
+        b = c;
+    return a > b ? a : b;
+}
+
+s32 DSP_Process(const struct dsp_config *cfg, struct dsp_state *st, s32 value)
+{
+    if (!st->primed) {
+        st->hist[0] = st->hist[1] = st->out = value;
+        st->acc = value * 256;
+        st->dir = 0;
+        st->primed = 1;
+        return value;
+    }
+    s32 in = value;
+    switch (cfg->filter) {
+    case DSP_FILTER_MEDIAN:
+        value = median3(st->hist[0], st->hist[1], value);
+        break;
+    case DSP_FILTER_IIR:
+        st->acc += (value * 256 - st->acc) >> (cfg->smoothing > DSP_MAX_SMOOTHING ? DSP_MAX_SMOOTHING : cfg->smoothing);
+        value = (st->acc + 128) >> 8;
+        break;
+    }
+    st->hist[0] = st->hist[1];
+    st->hist[1] = in;
+
+    s32 step = value - st->out;
+    if (cfg->deadband) {
+        s8 dir = step > 0 ? 1 : step < 0 ? -1 : 0;
+        if (abs(step) > cfg->deadband * TRAVEL_STEP || (dir && dir == st->dir)) {
+            st->dir = dir;
+        } else {
+            st->dir = 0;
+            value = st->out;
+        }
+    }
+    if (cfg->slew)
+        value = DSP_Slew(value, st->out, cfg->slew * TRAVEL_STEP);
+    st->out = value;
+    return value;
+}
+
+#define TESTNAME dsp
+#include <tests.h>
@@ -0,0 +1,62 @@
+#ifndef _DSP_H_
+#define _DSP_H_
+
+/* Fixed-point input conditioning, run once per ADC frame.
+ * Calibration is a multiply by a reciprocal that is only recomputed when the
+ * calibration changes.  The calibrated value then goes through:
+ *   median-of-3 spike rejection (DSP_FILTER_MEDIAN)
+ *   or a one-pole IIR low-pass (DSP_FILTER_IIR)
+ *   an adaptive deadband, which holds the output while the input jitters
+ *     around it, but follows small steps as long as they keep going the
+ *     same way
+ *   a slew limit
+ * Values are in the CHAN_MIN_VALUE..CHAN_MAX_VALUE range.
+ */
+enum DspFilter {
+    DSP_FILTER_NONE,
+    DSP_FILTER_MEDIAN,
+    DSP_FILTER_IIR,
+    DSP_FILTER_LAST,
+};
+
+#define DSP_MAX_SMOOTHING 6
+
+/* One per calibrated input in InputDSP[] (config/tx.c), saved with the
+ * calibration in tx.ini.  All 0 disables it.  It is deliberately not part of
+ * struct Transmitter, which would change the fixed-id CRC */
+struct dsp_config {
+    u8 filter;     // enum DspFilter
+    u8 smoothing;  // IIR: the output moves 1/2^smoothing of the way per frame
+    u8 deadband;   // in 0.1% of full travel
+    u8 slew;       // maximum change per frame in 0.1% of full travel
+};
+
+struct dsp_calibration {
+    u16 zero;
+    s32 pos_gain;   // Q16 gains for either side of zero
+    s32 neg_gain;
+};
+
+struct dsp_state {
+    s16 hist[2];    // previous inputs, for the median
+    s16 out;
+    s8 dir;         // direction of the last step through the deadband
+    u8 primed;
+    s32 acc;        // IIR accumulator, Q8
+};
+
+void DSP_SetCalibration(struct dsp_calibration *cal, u16 min, u16 max, u16 zero);
+s32 DSP_Calibrate(const struct dsp_calibration *cal, s32 value);
+s32 DSP_Process(const struct dsp_config *cfg, struct dsp_state *st, s32 value);
+
+/* Limits the change from 'prev' to 'rate' */
+static inline s32 DSP_Slew(s32 value, s32 prev, s32 rate)
+{
+    if (value - prev > rate)
+        return prev + rate;
+    if (value - prev < -rate)
+        return prev - rate;
+    return value;
+}
+
+#endif // _DSP_H_
@@ -27,15 +27,64 @@
 #if HAS_EXTENDED_AUDIO
 u16 voice_map_entries;
 struct VoiceMap voice_map[MAX_VOICEMAP_ENTRIES];
-u16 audio_queue[AUDIO_QUEUE_LENGTH];
-u8 next_audio;
-u8 num_audio;
 u32 audio_queue_time;
 
+/* Voice output is queued as announcements: a leading mp3 optionally
+ * followed by the digits and unit of a value.  The queue is a ring of
+ * pending announcements; the announcement being spoken is moved out of
+ * the ring into 'current'.  Alarms are taken before normal announcements,
+ * and a new announcement replaces a pending one with the same leading mp3
+ * so only the latest value of a source is spoken.
+ */
+struct AudioAnnouncement {
+    u16 clip[AUDIO_MAX_CLIPS];
+    u8 num_clips;
+    u8 priority;
+};
+
+static struct AudioAnnouncement audio_queue[AUDIO_QUEUE_LENGTH];
+static u8 queue_head;
+static u8 queue_count;
+static struct AudioAnnouncement current;
+static u8 current_clip;
+static u8 audio_active;
+static u8 queue_priority;
+static volatile u8 clip_finished;
+
 #ifndef EMULATOR
 static u8 player_buffer[] = {0x7E, 0xFF, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xEF};
 #endif
 
+// The DFPlayer sends a 0x3D message when it finishes playing an mp3, and
+// then sends it a second time.  The repeat carries the same track number and
+// follows immediately, long before any clip we queued next could finish.
+#define DFPLAYER_REPEAT_MSEC 200
+
+// Called in interrupt context
+static void _dfplayer_rx(u8 ch, u8 status)
+{
+    static u8 frame[10];
+    static u8 pos;
+    static u16 finished_track;
+    static u32 finished_time;
+    (void)status;
+    if (pos == 0 && ch != 0x7E)
+        return;
+    frame[pos++] = ch;
+    if (pos < sizeof(frame))
+        return;
+    pos = 0;
+    if (frame[3] != 0x3D || frame[9] != 0xEF)
+        return;
+    u16 track = (frame[5] << 8) | frame[6];
+    u32 t = CLOCK_getms();
+    if (track == finished_track && t - finished_time < DFPLAYER_REPEAT_MSEC)
+        return;
+    finished_track = track;
+    finished_time = t;
+    AUDIO_ClipFinished();
+}
+
 // Initialize UART for extended-audio
 void AUDIO_Init() {
     if (Transmitter.audio_player == AUDIO_DISABLED) {
@@ -67,6 +116,8 @@ void AUDIO_Init() {
 #endif // _DEVO12_TARGET_H_
         printf("Voice: Setting up UART for extended-audio\n");
         UART_SetDataRate(9600);
+        if (Transmitter.audio_player == AUDIO_DF_PLAYER)
+            UART_StartReceive(_dfplayer_rx);
 #ifndef _DEVO12_TARGET_H_
     }
 #endif // _DEVO12_TARGET_H_
@@ -189,20 +240,75 @@ void AUDIO_SetVolume() {
 #endif
 }
 
+static struct AudioAnnouncement *_queue_entry(int i)
+{
+    return &audio_queue[(queue_head + i) % AUDIO_QUEUE_LENGTH];
+}
+
+static void _queue_remove(int i)
+{
+    for (; i < queue_count - 1; i++)
+        *_queue_entry(i) = *_queue_entry(i + 1);
+    queue_count--;
+}
+
+// Drop the pending announcements and the rest of the one being spoken
+void AUDIO_ClearQueue()
+{
+    queue_count = 0;
+    current.num_clips = 0;
+    current_clip = 0;
+}
+
+// Move the oldest announcement with the highest priority out of the queue
+static int _next_announcement()
+{
+    int best = -1;
+    for (int i = 0; i < queue_count; i++) {
+        if (best < 0 || _queue_entry(i)->priority > _queue_entry(best)->priority)
+            best = i;
+    }
+    if (best < 0)
+        return 0;
+    current = *_queue_entry(best);
+    current_clip = 0;
+    if (best == 0) {
+        queue_head = (queue_head + 1) % AUDIO_QUEUE_LENGTH;
+        queue_count--;
+    } else {
+        _queue_remove(best);
+    }
+    return 1;
+}
+
 void AUDIO_CheckQueue() {
     u32 t = CLOCK_getms();
-    if (next_audio < num_audio) {
-        if (t > audio_queue_time) {
-            AUDIO_Play(audio_queue[next_audio]);
-            audio_queue_time = CLOCK_getms() + voice_map[audio_queue[next_audio]].duration;
-            next_audio++;
+    if (t <= audio_queue_time && !clip_finished)
+        return;
+    clip_finished = 0;
+    if (current_clip >= current.num_clips && !_next_announcement()) {
+        if (audio_active) {
+            printf("Voice: Queue finished.\n");
+            audio_active = 0;
+            AUDIO_SetVolume();
         }
-    } else if (num_audio && t > audio_queue_time) {
-        printf("Voice: Queue finished, resetting.\n");
-        num_audio = 0;
-        next_audio = 0;
-        AUDIO_SetVolume();
+        return;
     }
+    u16 music = current.clip[current_clip++];
+    AUDIO_Play(music);
+    audio_active = 1;
+    // The player normally reports the end of the mp3 through AUDIO_ClipFinished(),
+    // the mp3 length from voice.ini is only used as a timeout
+    audio_queue_time = CLOCK_getms() + voice_map[music].duration;
+}
+
+void AUDIO_ClipFinished() {
+    if (audio_active)
+        clip_finished = 1;
+}
+
+int AUDIO_Busy() {
+    return audio_active || queue_count;
 }
 
 int AUDIO_VoiceAvailable() {
@@ -212,8 +318,7 @@ int AUDIO_VoiceAvailable() {
 #endif
     {
         printf("Voice: Dev mode enabled, cannot set volume\n");
-        num_audio = 0;  // Reset queue when audio not available
-        next_audio = 0;
+        AUDIO_ClearQueue();  // Reset queue when audio not available
         return 0;
     }
 #endif  // BUILDTYPE_DEV
@@ -224,33 +329,70 @@ int AUDIO_VoiceAvailable() {
     if ( PPMin_Mode() || Model.protocol == PROTOCOL_PPM ) { // don't send play command when using PPM port
 #endif
         printf("Voice: PPM port in use\n");
-        num_audio = 0;  // Reset queue when audio not available
-        next_audio = 0;
+        AUDIO_ClearQueue();  // Reset queue when audio not available
         return 0;
     }
 #endif // _DEVO12_TARGET_H_
 
     if ( (Transmitter.audio_player == AUDIO_NONE) || (Transmitter.audio_player == AUDIO_DISABLED) || !Transmitter.audio_vol ) {
-        num_audio = 0; // Reset queue when audio not available
-        next_audio = 0;
+        AUDIO_ClearQueue();  // Reset queue when audio not available
         return 0;
     }
 
     return 1;
 }
 
+// Priority of the announcements added from now on
+void AUDIO_SetPriority(u8 priority) {
+    queue_priority = priority;
+}
+
+// Start a new announcement with 'music'
 int AUDIO_AddQueue(u16 music) {
-    if (num_audio == AUDIO_QUEUE_LENGTH) {
-        printf("Voice: Queue full, cannot add new mp3 #%d\n",music);
-        return 0;
-    }
+    u8 priority = queue_priority;
     if (!voice_map[music].duration) {
         printf("Voice: mp3 length is zero\n");
         return 0;
     }
+    // Coalesce with a pending announcement of the same source
+    for (int i = 0; i < queue_count; i++) {
+        if (_queue_entry(i)->clip[0] == music) {
+            _queue_remove(i);
+            break;
+        }
+    }
+    if (queue_count == AUDIO_QUEUE_LENGTH) {
+        // Drop the oldest announcement which is not more important than this one
+        int drop = -1;
+        for (int i = 0; i < queue_count && drop < 0; i++) {
+            if (_queue_entry(i)->priority <= priority)
+                drop = i;
+        }
+        if (drop < 0) {
+            printf("Voice: Queue full, cannot add new mp3 #%d\n", music);
+            return 0;
+        }
+        printf("Voice: Queue full, dropping mp3 #%d\n", _queue_entry(drop)->clip[0]);
+        _queue_remove(drop);
+    }
+    struct AudioAnnouncement *a = _queue_entry(queue_count++);
+    a->clip[0] = music;
+    a->num_clips = 1;
+    a->priority = priority;
+    return 1;
+}
 
-    audio_queue[num_audio++] = music;
+// Add 'music' to the announcement started by the last AUDIO_AddQueue()
+int AUDIO_AppendQueue(u16 music) {
+    if (!queue_count)
+        return 0;
+    struct AudioAnnouncement *a = _queue_entry(queue_count - 1);
+    if (a->num_clips == AUDIO_MAX_CLIPS || !voice_map[music].duration)
+        return 0;
+    a->clip[a->num_clips++] = music;
     return 1;
 }
 
+#define TESTNAME extended_audio
+#include <tests.h>
 #endif
@@ -3,18 +3,26 @@
 
 #if HAS_EXTENDED_AUDIO
 
-#define AUDIO_QUEUE_LENGTH 20 // arbitraty chosen, do we need more?
+#define AUDIO_QUEUE_LENGTH 8   // announcements waiting to be played
+#define AUDIO_MAX_CLIPS   10   // mp3s per announcement (prefix, sign, digits, unit)
+
+enum {
+    AUDIO_PRIO_NORMAL = 0,
+    AUDIO_PRIO_ALARM,
+};
 
 void AUDIO_Init();
 int AUDIO_Play(u16 music);
 void AUDIO_SetVolume();
 void AUDIO_CheckQueue();
+void AUDIO_ClearQueue();
 int AUDIO_AddQueue(u16 music);
+int AUDIO_AppendQueue(u16 music);
+void AUDIO_SetPriority(u8 priority);
+void AUDIO_ClipFinished();
+int AUDIO_Busy();
 int AUDIO_VoiceAvailable();
 
-extern u16 audio_queue[AUDIO_QUEUE_LENGTH];
-extern u8 next_audio;
-extern u8 num_audio;
 extern u32 audio_queue_time;
 
 #endif
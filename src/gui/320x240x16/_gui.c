@@ -52,6 +52,10 @@ void _gui_draw_background(int x, int y, int w, int h)
             LCD_FillRect(x, 32, w, h - 32 + y, Display.background.bg_color);
         }
     } else {
+        // A full redraw means a new page: make sure the background is cached
+        // so the partial redraws that follow don't go back to the file
+        if (w == LCD_WIDTH && h == LCD_HEIGHT)
+            LCD_CacheImage("media/backgrnd" IMG_EXT);
         LCD_DrawWindowedImageFromFile(x, y, "media/backgrnd" IMG_EXT, w, h, x, y);
     }
 }
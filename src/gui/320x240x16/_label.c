@@ -33,7 +33,8 @@ void GUI_DrawLabelHelper(u16 obj_x, u16 obj_y, u16 obj_w, u16 obj_h, const char
     } else {
         GUI_DrawBackground(obj_x, obj_y, obj_w, obj_h);
     }
-    if (desc->style != LABEL_LISTBOX && desc->fill_color != desc->outline_color) {
+    u8 outline = desc->style != LABEL_LISTBOX && desc->fill_color != desc->outline_color;
+    if (outline) {
         LCD_DrawRect(obj_x, obj_y, obj_w, obj_h, desc->outline_color);
         obj_x+=2; obj_w-=4;
     }
@@ -60,6 +61,16 @@ void GUI_DrawLabelHelper(u16 obj_x, u16 obj_y, u16 obj_w, u16 obj_h, const char
             LCD_SetFontColor(desc->font_color);
         }
     }
+    // On a solid fill the glyphs can be sent opaque, which needs no per-span addressing
+    u8 opaque = (desc->style == LABEL_LISTBOX || desc->style == LABEL_FILL)
+                && txt_x >= obj_x && txt_x + txt_w <= obj_x + obj_w
+                && txt_y >= obj_y + outline && txt_y + txt_h <= obj_y + obj_h - outline;
+    if (opaque)
+        LCD_SetFontBackground(desc->style == LABEL_LISTBOX
+                              ? (is_selected ? Display.listbox.bg_select : Display.listbox.bg_color)
+                              : desc->fill_color);
     LCD_PrintStringXY(txt_x, txt_y, str);
+    if (opaque)
+        LCD_SetFontBackground(FONT_TRANSPARENT);
 }
 
@@ -214,6 +214,7 @@ void GUI_DrawBackground(u16 x, u16 y, u16 w, u16 h)
 {
     if(w == 0 || h == 0)
         return;
+    _GUI_XYGraphInvalidate(x, y, w, h);
     if(FullRedraw != REDRAW_ONLY_DIRTY) {
         if(w == LCD_WIDTH && h == LCD_HEIGHT)
             _gui_draw_background(x, y, w, h); //Optimization to prevent partial redraw when it isn't needed
@@ -305,6 +305,7 @@ void GUI_PressTextSelect(struct guiObject *obj, u32 button, u8 press_type);
 
 void GUI_DrawXYGraph(struct guiObject *obj);
 u8 GUI_TouchXYGraph(struct guiObject *obj, struct touch *coords, u8 long_press);
+void _GUI_XYGraphInvalidate(u16 x, u16 y, u16 w, u16 h);
 
 void GUI_DrawLabel(struct guiObject *obj);
 u8 GUI_TouchLabel(struct guiObject *obj, struct touch *coords, s8 press_type);
@@ -20,6 +20,37 @@
 
 #include "_mapped_gfx.h"
 
+#ifndef XYGRAPH_CACHE_WIDTH
+    #if LCD_DEPTH == 16
+        #define XYGRAPH_CACHE_WIDTH LCD_WIDTH
+    #else
+        #define XYGRAPH_CACHE_WIDTH 0
+    #endif
+#endif
+#define XYGRAPH_MAX_POINTS 16
+
+#define VAL_TO_X(xval) \
+    (u32)(box->x + (((s32)(xval)) - graph->min_x + 1) * box->width / (1 + graph->max_x - graph->min_x))
+#define VAL_TO_Y(yval) \
+    (u32)(box->y + box->height - (((s32)(yval)) - graph->min_y + 1) * box->height / (1 + graph->max_y - graph->min_y))
+
+struct xy_points {
+    u8 count;
+    s16 x[XYGRAPH_MAX_POINTS];
+    s16 y[XYGRAPH_MAX_POINTS];
+};
+
+#if XYGRAPH_CACHE_WIDTH
+/* What was last drawn for one graph (normally the curve being edited).
+ * A redraw diffs against it and only repaints the columns where the curve
+ * or a marker moved.  Any background redraw over the graph drops it. */
+static struct {
+    struct guiObject *owner;
+    s16 row[XYGRAPH_CACHE_WIDTH];
+    struct xy_points points;
+} graph_cache;
+#endif
+
 guiObject_t *GUI_CreateXYGraph(guiXYGraph_t *graph, u16 x, u16 y, u16 width, u16 height,
                       s16 min_x, s16 min_y, s16 max_x, s16 max_y,
                       u16 gridx, u16 gridy,
@@ -31,6 +62,10 @@ guiObject_t *GUI_CreateXYGraph(guiXYGraph_t *graph, u16 x, u16 y, u16 width, u16
     struct guiObject  *obj   = (guiObject_t *)graph;
     struct guiBox    *box;
     CLEAR_OBJ(graph);
+#if XYGRAPH_CACHE_WIDTH
+    if (graph_cache.owner == obj)
+        graph_cache.owner = NULL;
+#endif
 
     box = &obj->box;
 
@@ -59,24 +94,79 @@ guiObject_t *GUI_CreateXYGraph(guiXYGraph_t *graph, u16 x, u16 y, u16 width, u16
     return obj;
 }
 
-void GUI_DrawXYGraph(struct guiObject *obj)
+static s16 curve_row(struct guiObject *obj, int x)
+{
+    struct guiBox *box = &obj->box;
+    struct guiXYGraph *graph = (struct guiXYGraph *)obj;
+    s32 xval, yval, y;
+    xval = graph->min_x + x * (1 + graph->max_x - graph->min_x) / box->width;
+    yval = graph->CallBack(xval, graph->cb_data);
+    y = (yval - graph->min_y) * box->height / (1 + graph->max_y - graph->min_y);
+    //printf("%d: (%d, %d) -> %d\n", x, (int)xval, (int)yval, (int)y);
+    return box->height - y - 1;
+}
+
+static void get_points(struct guiObject *obj, struct xy_points *points)
+{
+    struct guiXYGraph *graph = (struct guiXYGraph *)obj;
+    points->count = 0;
+    if (! graph->point_cb)
+        return;
+    s16 xval, yval;
+    while (points->count < XYGRAPH_MAX_POINTS
+           && graph->point_cb(&xval, &yval, points->count, graph->cb_data)) {
+        points->x[points->count] = xval;
+        points->y[points->count] = yval;
+        points->count++;
+    }
+}
+
+static void point_rect(struct guiObject *obj, s16 xval, s16 yval, s16 rect[4])
 {
     struct guiBox *box = &obj->box;
     struct guiXYGraph *graph = (struct guiXYGraph *)obj;
+    s16 x1 = VAL_TO_X(xval);
+    s16 y1 = VAL_TO_Y(yval);
+    s16 x2 = x1 + 2;
+    s16 y2 = y1 + 2;
+    //bounds check
+    x1 = ( x1 < 2 + box->x) ? box->x : x1 - 2;
+    y1 = ( y1 < 2 + box->y) ? box->y : y1 - 2;
+    if ( x2 >= box->x + box->width)
+        x2 = box->x + box->width - 1;
+    if ( y2 >= box->y + box->height)
+        y2 = box->y + box->height - 1;
+    rect[0] = x1;
+    rect[1] = y1;
+    rect[2] = x2;
+    rect[3] = y2;
+}
+
+/* Draw columns c0..c1 (relative to the box) from scratch.  A curve segment
+ * also covers the column next to it, so neighbouring segments, markers and
+ * outline are repainted one column wider to keep their stacking order.
+ * 'rows' may be NULL, in which case the curve is evaluated while drawing. */
+static void draw_columns(struct guiObject *obj, const s16 *rows, const struct xy_points *points, int c0, int c1)
+{
+    struct guiBox *box = &obj->box;
+    struct guiXYGraph *graph = (struct guiXYGraph *)obj;
+    u8 full = (c0 == 0 && c1 == box->width - 1);
+    u16 left = box->x + c0;
+    u16 right = box->x + c1;
     u32 x, y;
 
-    #define VAL_TO_X(xval) \
-        (u32)(box->x + (((s32)(xval)) - graph->min_x + 1) * box->width / (1 + graph->max_x - graph->min_x))
-    #define VAL_TO_Y(yval) \
-        (u32)(box->y + box->height - (((s32)(yval)) - graph->min_y + 1) * box->height / (1 + graph->max_y - graph->min_y))
-    _GUI_DrawMappedStart();
-    _GUI_ClearMappedBox(box, Display.xygraph.bg_color);
+    if (full)
+        _GUI_ClearMappedBox(box, Display.xygraph.bg_color);
+    else
+        LCD_FillRect(left, box->y, c1 - c0 + 1, box->height, Display.xygraph.bg_color);
     if (graph->grid_x) {
         int xval;
         for (xval = graph->min_x + graph->grid_x; xval < graph->max_x; xval += graph->grid_x) {
             if (! xval)
                 continue;
             x = VAL_TO_X(xval);
+            if (x < left || x > right)
+                continue;
             //LCD_DrawDashedVLine(x, box->y, box->height, 5, RGB888_to_RGB565(0x30, 0x30, 0x30));
             LCD_DrawFastVLine(x, box->y, box->height, Display.xygraph.grid_color);
         }
@@ -88,54 +178,155 @@ void GUI_DrawXYGraph(struct guiObject *obj)
                 continue;
             y = VAL_TO_Y(yval);
             //LCD_DrawDashedHLine(box->x, y, box->width, 5, RGB888_to_RGB565(0x30, 0x30, 0x30));
-            LCD_DrawFastHLine(box->x, y, box->width, Display.xygraph.grid_color);
+            LCD_DrawFastHLine(left, y, c1 - c0 + 1, Display.xygraph.grid_color);
         }
     }
     if (graph->min_x < 0 && graph->max_x > 0) {
-        int x = box->x + box->width * (0 - graph->min_x) / (graph->max_x - graph->min_x);
-        LCD_DrawFastVLine(x, box->y, box->height, Display.xygraph.axis_color);
+        x = box->x + box->width * (0 - graph->min_x) / (graph->max_x - graph->min_x);
+        if (x >= left && x <= right)
+            LCD_DrawFastVLine(x, box->y, box->height, Display.xygraph.axis_color);
     }
     if (graph->min_y < 0 && graph->max_y > 0) {
         y = box->y + box->height - box->height * (0 - graph->min_y) / (graph->max_y - graph->min_y);
-        LCD_DrawFastHLine(box->x, y, box->width, Display.xygraph.axis_color);
+        LCD_DrawFastHLine(left, y, c1 - c0 + 1, Display.xygraph.axis_color);
     }
-    u16 lastx = box->x;
-    u16 lasty = box->y + box->height -1;
+
+    int first = c0 ? c0 - 1 : 0;
+    int last = (c1 < box->width - 1) ? c1 + 1 : c1;
+    s16 lasty = 0;
     LCD_DrawStart(box->x, box->y, box->x + box->width - 1, box->y + box->height - 1, DRAW_NWSE);
-    for (x = 0; x < box->width; x++) {
-        s32 xval, yval;
-        xval = graph->min_x + x * (1 + graph->max_x - graph->min_x) / box->width;
-        yval = graph->CallBack(xval, graph->cb_data);
-        y = (yval - graph->min_y) * box->height / (1 + graph->max_y - graph->min_y);
-        //printf("(%d, %d - %d, %d) -> (%d, %d)\n",
-        //       (int)lastx, (int)lasty, (int)x, (int)y, (int)xval, (int)yval);
-        if (x != 0) {
-            LCD_DrawLine(lastx, lasty, x + box->x, box->y + box->height - y - 1, Display.xygraph.fg_color); //Yellow
+    for (int col = first; col <= last; col++) {
+        s16 row = rows ? rows[col] : curve_row(obj, col);
+        if (col != first) {
+            LCD_DrawLine(box->x + col - 1, box->y + lasty, box->x + col, box->y + row, Display.xygraph.fg_color); //Yellow
         }
-        lastx = x + box->x;
-        lasty = box->y + box->height - y - 1;
+        lasty = row;
     }
     LCD_DrawStop();
-    if (graph->point_cb) {
-        u8 pos = 0;
-        s16 xval, yval;
-        while (graph->point_cb(&xval, &yval, pos++, graph->cb_data)) {
-            s16 x1 = VAL_TO_X(xval);
-            s16 y1 = VAL_TO_Y(yval);
-            s16 x2 = x1 + 2;
-            s16 y2 = y1 + 2;
-            //bounds check
-            x1 = ( x1 < 2 + box->x) ? box->x : x1 - 2;
-            y1 = ( y1 < 2 + box->y) ? box->y : y1 - 2;
-            if ( x2 >= box->x + box->width)
-                x2 = box->x + box->width - 1;
-            if ( y2 >= box->y + box->height)
-                y2 = box->y + box->height - 1;
-            LCD_FillRect(x1, y1, x2 - x1 + 1, y2 - y1 + 1, Display.xygraph.point_color);
+
+    left = box->x + first;
+    right = box->x + last;
+    for (int i = 0; i < points->count; i++) {
+        s16 rect[4];
+        point_rect(obj, points->x[i], points->y[i], rect);
+        if (rect[2] < left || rect[0] > right)
+            continue;
+        LCD_FillRect(rect[0], rect[1], rect[2] - rect[0] + 1, rect[3] - rect[1] + 1, Display.xygraph.point_color);
+        // the outline goes on top of any marker drawn here
+        if (rect[0] < left)
+            left = rect[0];
+        if (rect[2] > right)
+            right = rect[2];
+    }
+    if(Display.xygraph.outline_color != Display.xygraph.bg_color) {
+        if (full) {
+            LCD_DrawRect(box->x, box->y, box->width, box->height, Display.xygraph.outline_color);
+        } else {
+            LCD_DrawFastHLine(left, box->y, right - left + 1, Display.xygraph.outline_color);
+            LCD_DrawFastHLine(left, box->y + box->height - 1, right - left + 1, Display.xygraph.outline_color);
+            if (left == box->x)
+                LCD_DrawFastVLine(box->x, box->y, box->height, Display.xygraph.outline_color);
+            if (right == box->x + box->width - 1)
+                LCD_DrawFastVLine(right, box->y, box->height, Display.xygraph.outline_color);
         }
     }
-    if(Display.xygraph.outline_color != Display.xygraph.bg_color)
-        LCD_DrawRect(box->x, box->y, box->width, box->height, Display.xygraph.outline_color);
+}
+
+#if XYGRAPH_CACHE_WIDTH
+static void mark_columns(u8 *dirty, int c0, int c1, int width)
+{
+    if (c0 < 0)
+        c0 = 0;
+    if (c1 >= width)
+        c1 = width - 1;
+    for (int c = c0; c <= c1; c++)
+        dirty[c / 8] |= 1 << (c % 8);
+}
+
+static void mark_point(struct guiObject *obj, u8 *dirty, s16 xval, s16 yval)
+{
+    s16 rect[4];
+    point_rect(obj, xval, yval, rect);
+    mark_columns(dirty, rect[0] - obj->box.x, rect[2] - obj->box.x, obj->box.width);
+}
+
+/* Redraw only what changed since the graph was last drawn into the cache.
+ * Returns 0 if the cache can't be used and a full redraw is needed */
+static int draw_changes(struct guiObject *obj, const struct xy_points *points)
+{
+    struct guiBox *box = &obj->box;
+    u8 dirty[(XYGRAPH_CACHE_WIDTH + 7) / 8];
+    int valid = (graph_cache.owner == obj);
+
+    memset(dirty, 0, sizeof(dirty));
+    for (int x = 0; x < box->width; x++) {
+        s16 row = curve_row(obj, x);
+        if (valid && row != graph_cache.row[x])
+            mark_columns(dirty, x - 1, x + 1, box->width);
+        graph_cache.row[x] = row;
+    }
+    graph_cache.owner = obj;
+    if (! valid)
+        return 0;
+
+    struct xy_points *old = &graph_cache.points;
+    for (int i = 0; i < old->count || i < points->count; i++) {
+        if (i < old->count && i < points->count
+            && old->x[i] == points->x[i] && old->y[i] == points->y[i])
+            continue;
+        if (i < old->count)
+            mark_point(obj, dirty, old->x[i], old->y[i]);
+        if (i < points->count)
+            mark_point(obj, dirty, points->x[i], points->y[i]);
+    }
+
+    int c0 = -1;
+    for (int c = 0; c <= box->width; c++) {
+        int is_dirty = c < box->width && (dirty[c / 8] & (1 << (c % 8)));
+        if (is_dirty && c0 < 0) {
+            c0 = c;
+        } else if (! is_dirty && c0 >= 0) {
+            draw_columns(obj, graph_cache.row, points, c0, c - 1);
+            c0 = -1;
+        }
+    }
+    return 1;
+}
+
+void _GUI_XYGraphInvalidate(u16 x, u16 y, u16 w, u16 h)
+{
+    struct guiObject *obj = graph_cache.owner;
+    if (obj && ! (obj->box.x >= x + w || obj->box.x + obj->box.width <= x
+                  || obj->box.y >= y + h || obj->box.y + obj->box.height <= y))
+        graph_cache.owner = NULL;
+}
+#else
+void _GUI_XYGraphInvalidate(u16 x, u16 y, u16 w, u16 h)
+{
+    (void)x;
+    (void)y;
+    (void)w;
+    (void)h;
+}
+#endif
+
+void GUI_DrawXYGraph(struct guiObject *obj)
+{
+    struct guiBox *box = &obj->box;
+    struct xy_points points;
+
+    get_points(obj, &points);
+    _GUI_DrawMappedStart();
+#if XYGRAPH_CACHE_WIDTH
+    if (box->width <= XYGRAPH_CACHE_WIDTH) {
+        if (! draw_changes(obj, &points))
+            draw_columns(obj, graph_cache.row, &points, 0, box->width - 1);
+        graph_cache.points = points;
+        _GUI_DrawMappedStop();
+        return;
+    }
+#endif
+    draw_columns(obj, NULL, &points, 0, box->width - 1);
     _GUI_DrawMappedStop();
 }
 
@@ -260,6 +260,162 @@ const char *INPUT_ButtonName(unsigned button)
     return "";
 }
 
+/* Name lookup for the config parsers.
+ * Every source name (also without the switch position), stick name, old
+ * source alias and button name is hashed once into name_hash, which holds
+ * a key id per slot.  A hit is confirmed by regenerating the name of that
+ * key, so matching is exactly as lenient as mapstrcasecmp().
+ * Key ids: 0..NUM_SOURCES are the sources, followed by the 4 stick names,
+ * the INPUT_MapSourceName() aliases and the buttons.
+ */
+#define NAME_HASH_SIZE  256
+#define NAME_HASH_EMPTY 0xff
+#define KEY_STICK (NUM_SOURCES + 1)
+#define KEY_ALIAS (KEY_STICK + 4)
+enum {
+    NUM_SOURCE_ALIASES = sizeof((u8[]){
+        0,
+        #define CHANMAP(oldname, new) 0,
+        #include "capabilities.h"
+        #undef CHANMAP
+    }) - 1,
+};
+// Every key is hashed as a name, the sources also as an abbreviation
+#define NAME_HASH_KEYS (KEY_ALIAS + NUM_SOURCE_ALIASES + NUM_SOURCES + 1 + NUM_TX_BUTTONS + 1)
+ctassert((NAME_HASH_KEYS <= NAME_HASH_SIZE * 3 / 4), too_many_source_names);
+
+enum {
+    NAME_SOURCE,
+    NAME_ABBREV,
+    NAME_BUTTON,
+};
+
+static u8 name_hash[NAME_HASH_SIZE];
+static u8 key_button;  // first button key, 0 until name_hash is built
+
+static unsigned hash_name(const char *str)
+{
+    // FNV-1a over the name with case and ' '/'_' folded like mapstrcasecmp
+    u32 hash = 2166136261u;
+    for (; *str; str++) {
+        u8 c = *str;
+        if (c == ' ')
+            c = '_';
+        else if (c >= 'A' && c <= 'Z')
+            c += 'a' - 'A';
+        hash = (hash ^ c) * 16777619u;
+    }
+    return hash & (NAME_HASH_SIZE - 1);
+}
+
+static const char *key_name(char *str, unsigned key, int type)
+{
+    unsigned val;
+    if (type == NAME_BUTTON)
+        return key >= key_button ? INPUT_ButtonName(key - key_button) : NULL;
+    if (key <= NUM_SOURCES)
+        return type == NAME_ABBREV ? INPUT_SourceNameAbbrevSwitchReal(str, key)
+                                   : INPUT_SourceNameReal(str, key);
+    if (type == NAME_ABBREV)
+        return NULL;
+    if (key < KEY_ALIAS)
+        return tx_stick_names[key - KEY_STICK];
+    if (key < key_button)
+        return INPUT_MapSourceName(key - KEY_ALIAS, &val);
+    return NULL;
+}
+
+static int find_key(const char *name, int type)
+{
+    char str[10];
+    unsigned pos = hash_name(name);
+    // NAME_HASH_KEYS leaves free slots, the bound only guards against a hang
+    for (unsigned i = 0; i < NAME_HASH_SIZE; i++) {
+        u8 key = name_hash[pos];
+        if (key == NAME_HASH_EMPTY)
+            break;
+        const char *keyname = key_name(str, key, type);
+        if (keyname && mapstrcasecmp(keyname, name) == 0)
+            return key;
+        pos = (pos + 1) & (NAME_HASH_SIZE - 1);
+    }
+    return -1;
+}
+
+static void add_key(unsigned key, int type)
+{
+    char str[10];
+    const char *name = key_name(str, key, type);
+    // The first key with a given name wins, as it did for the linear search
+    if (! name || find_key(name, type) >= 0)
+        return;
+    unsigned pos = hash_name(name);
+    // NAME_HASH_KEYS leaves free slots, the bound only guards against a hang
+    for (unsigned i = 0; i < NAME_HASH_SIZE; i++) {
+        if (name_hash[pos] == NAME_HASH_EMPTY) {
+            name_hash[pos] = key;
+            return;
+        }
+        pos = (pos + 1) & (NAME_HASH_SIZE - 1);
+    }
+}
+
+static void build_name_hash()
+{
+    unsigned key, val;
+    // Lookups come from CONFIG_IniParse, which uses the untranslated names
+    CONFIG_EnableLanguage(0);
+    memset(name_hash, NAME_HASH_EMPTY, sizeof(name_hash));
+    key_button = KEY_ALIAS;
+    while (INPUT_MapSourceName(key_button - KEY_ALIAS, &val))
+        key_button++;
+    for (key = 0; key < key_button; key++)
+        add_key(key, NAME_SOURCE);
+    for (key = 0; key <= NUM_SOURCES; key++)
+        add_key(key, NAME_ABBREV);
+    for (key = 0; key <= NUM_TX_BUTTONS; key++)
+        add_key(key_button + key, NAME_BUTTON);
+    CONFIG_EnableLanguage(1);
+}
+
+static int lookup_name(const char *name, int type)
+{
+    if (! key_button)
+        build_name_hash();
+    return find_key(name, type);
+}
+
+/* Returns the source for a name as written by INPUT_SourceNameReal(), a
+ * stick name or an old alias, or -1.  A leading '!' is not handled here */
+int INPUT_FindSource(const char *name)
+{
+    unsigned val;
+    int key = lookup_name(name, NAME_SOURCE);
+    if (key < 0 || key <= NUM_SOURCES)
+        return key;
+    if (key < KEY_ALIAS)
+        return key - KEY_STICK + 1;
+    INPUT_MapSourceName(key - KEY_ALIAS, &val);
+    return val;
+}
+
+/* Like INPUT_FindSource() for INPUT_SourceNameAbbrevSwitchReal() names.
+ * A switch name resolves to the first position of that switch */
+int INPUT_FindAbbrevSource(const char *name)
+{
+    int key = lookup_name(name, NAME_ABBREV);
+    if (key < 0)
+        return -1;
+    int pos = INPUT_SwitchPos(key);
+    return pos > 0 ? key - pos : key;
+}
+
+int INPUT_FindButton(const char *name)
+{
+    int key = lookup_name(name, NAME_BUTTON);
+    return key < 0 ? -1 : key - key_button;
+}
+
 int INPUT_SelectInput(int src, int new_source, u8 *changed) {
     u8 is_neg = MIXER_SRC_IS_INV(src);
     if (changed) *changed = MIXER_SRC(src) == new_source ? 0 : 1;
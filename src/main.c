@@ -97,8 +97,6 @@ int main() {
     // AUDIO_Init() has already been called by CONFIG_ReadModel()
 #if HAS_EXTENDED_AUDIO
     audio_queue_time = CLOCK_getms() + 1500;
-    num_audio=1;
-    next_audio=1;
 #if (LCD_WIDTH == 480) || (LCD_WIDTH == 320)
     if(Display.background.drawn_background)
         while(CLOCK_getms() < audio_queue_time - 1200);
@@ -227,9 +225,11 @@ void EventLoop()
     	if(Transmitter.music_shutdown) {
 #if HAS_EXTENDED_AUDIO
         if(AUDIO_VoiceAvailable()) {
+            AUDIO_ClearQueue();  // Don't hold the power off for pending announcements
             MUSIC_Play(MUSIC_SHUTDOWN);
-            while (CLOCK_getms() < audio_queue_time) {
+            while (AUDIO_Busy()) {
                 // Wait for voice to finished
+                AUDIO_CheckQueue();
                 CLOCK_ResetWatchdog();
             }
         } else {
@@ -262,6 +262,7 @@ void EventLoop()
         BATTERY_Check();
         AUTODIMMER_Update();
 #if HAS_DATALOG
+        TELEMETRY_UpdateHistory();
         DATALOG_Update();
 #endif
 #if HAS_VIDEO
@@ -272,9 +273,8 @@ void EventLoop()
 #endif
         GUI_RefreshScreen();
 #if HAS_HARD_POWER_OFF
-        if (PAGE_ModelDoneEditing())
-            CONFIG_SaveModelIfNeeded();
-        CONFIG_SaveTxIfNeeded();
+        CONFIG_AutoSaveModel(PAGE_ModelDoneEditing());
+        CONFIG_AutoSaveTx();
 #endif
     }
 #ifdef TIMING_DEBUG
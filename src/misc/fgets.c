@@ -27,6 +27,24 @@ int _lseek_r(void *r, int ptr, int dir);
 int _ltell_r(void *r);
 int FS_Mount(void *FAT, const char *drive);
 
+/* One stream at a time can be given a write buffer with setvbuf().  Writes
+ * to it are collected and passed on to the filesystem when the buffer is
+ * full, or before any other operation on the stream
+ */
+static FILE *wstream;
+static char *wbuf;
+static unsigned wsize;
+static unsigned wlen;
+
+static int flush_write(FILE *stream)
+{
+    if (stream != wstream || ! wlen)
+        return 0;
+    int r = _write_r(stream, wbuf, wlen);
+    wlen = 0;
+    return r == -1 ? -1 : 0;
+}
+
 FILE *devo_fopen2(void *r, const char *path, const char *mode)
 {
     int flags = (mode && *mode == 'w') ? O_CREAT : 0;
@@ -40,32 +58,45 @@ FILE *devo_fopen2(void *r, const char *path, const char *mode)
 
 int devo_fclose(FILE *fp)
 {
+    flush_write(fp);
+    if (fp == wstream)
+        wstream = NULL;
     return _close_r(fp);
 }
 
 int devo_fseek(FILE *stream, long offset, int whence)
 {
+    flush_write(stream);
     return _lseek_r(stream, offset, whence);
 }
 
 int devo_ftell(FILE *stream)
 {
+    flush_write(stream);
     return _ltell_r(stream);
 }
 
 int devo_fputc(int c, FILE *stream) {
     char ch = c;
+    if (stream == wstream) {
+        wbuf[wlen++] = ch;
+        if (wlen == wsize && flush_write(stream))
+            return -1;
+        return c;
+    }
     return (_write_r(stream, &ch, 1) == -1) ? -1 : c;
 }
 
 #ifdef _f_gets
 char *devo_fgets(char *s, int size, FILE *stream) {
+    flush_write(stream);
     return _f_gets(s, size, stream);
 }
 #else
 extern unsigned char _stop_on_cr;
 char *devo_fgets(char *s, int size, FILE *stream)
 {
+    flush_write(stream);
     _stop_on_cr = 1;
     int r = _read_r(stream, s, size-1);
     _stop_on_cr = 0;
@@ -78,14 +109,27 @@ char *devo_fgets(char *s, int size, FILE *stream)
 
 size_t devo_fread(void *ptr, size_t size, size_t nmemb, FILE *stream)
 {
+    flush_write(stream);
     int r = _read_r(stream, ptr, size * nmemb);
     if (r <= 0)
         return 0;
-    return nmemb;
+    return r / size;
 }
 size_t devo_fwrite(void *ptr, size_t size, size_t nmemb, FILE *stream)
 {
-    int r = _write_r(stream, ptr, size * nmemb);
+    unsigned len = size * nmemb;
+    if (stream == wstream && len < wsize) {
+        if (wlen + len > wsize && flush_write(stream))
+            return 0;
+        memcpy(wbuf + wlen, ptr, len);
+        wlen += len;
+        if (wlen == wsize && flush_write(stream))
+            return 0;
+        return nmemb;
+    }
+    if (flush_write(stream))
+        return 0;
+    int r = _write_r(stream, ptr, len);
     if (r <= 0)
         return 0;
     return nmemb;
@@ -114,4 +158,18 @@ void devo_setbuf(FILE *stream, char *buf)
     (void)stream;
     (void)buf;
 }
+
+int devo_setvbuf(FILE *stream, char *buf, int mode, size_t size)
+{
+    if (wstream)
+        flush_write(wstream);
+    if (buf && size && mode != _IONBF) {
+        wstream = stream;
+        wbuf = buf;
+        wsize = size;
+    } else if (stream == wstream) {
+        wstream = NULL;
+    }
+    return 0;
+}
 #endif //! defined(EMULATOR) || EMULATOR == USE_INTERNAL_FS
@@ -65,6 +65,19 @@ static u32 prev_calcchannels_ms;
 
 static void MIXER_CreateCyclicOutput(volatile s32 *raw, s32 *cyclic);
 
+// Sources whose value changed, set by MIXER_CalcChannels() from the mixer
+// interrupt and collected by the GUI.  The GUI flips 'change_bank' before
+// reading, so it owns the old bank without having to block interrupts.
+static volatile u32 changes[2][MIXER_CHANGE_WORDS];
+static volatile u8 change_bank;
+// Trims touched by the trim buttons (main loop only)
+static u16 trim_changes;
+
+static void set_changed(unsigned idx)
+{
+    changes[change_bank][idx / 32] |= 1 << (idx % 32);
+}
+
 struct Mixer *MIXER_GetAllMixers()
 {
     return Model.mixers;
@@ -146,17 +159,26 @@ static void MIXER_UpdateRawInputs()
         if (PPMin_Mode() == PPM_IN_TRAIN2 && Model.train_sw && raw[Model.train_sw] > 0) {
             int ppm_channel_map = map_ppm_channels(i);
             if (ppm_channel_map >= 0) {
-                if (ppmSync) {
+                if (ppmSync && raw[i] != ppmChannels[ppm_channel_map]) {
                     raw[i] = ppmChannels[ppm_channel_map];
+                    set_changed(i);
                 }
                 continue;
             }
         }
-        raw[i] = CHAN_ReadInput(mapped_channel);
+        s32 value = CHAN_ReadInput(mapped_channel);
+        if (raw[i] != value) {
+            raw[i] = value;
+            set_changed(i);
+        }
     }
     if (PPMin_Mode() == PPM_IN_SOURCE && ppmSync) {
         for (i = 0; i < Model.num_ppmin_channels; i++) {
-            raw[1 + NUM_INPUTS + NUM_OUT_CHANNELS + NUM_VIRT_CHANNELS + i] = ppmChannels[i];
+            int idx = 1 + NUM_INPUTS + NUM_OUT_CHANNELS + NUM_VIRT_CHANNELS + i;
+            if (raw[idx] != ppmChannels[i]) {
+                raw[idx] = ppmChannels[i];
+                set_changed(idx);
+            }
         }
     }
 }
@@ -182,6 +204,9 @@ void MIXER_CalcChannels()
 
     //We retain this array so that we can refer to the prevous values in the next iteration
     int i;
+    s32 prev[NUM_CHANNELS];
+    for (i = 0; i < NUM_CHANNELS; i++)
+        prev[i] = raw[NUM_INPUTS + 1 + i];
     //1st step: Read Tx inputs
     MIXER_UpdateRawInputs();
     //3rd steps
@@ -199,10 +224,43 @@ void MIXER_CalcChannels()
                 break;
         }
     }
+    for (i = 0; i < NUM_CHANNELS; i++) {
+        if (raw[NUM_INPUTS + 1 + i] != prev[i])
+            set_changed(NUM_INPUTS + 1 + i);
+    }
     //5th step: apply limits
     for (i = 0; i < NUM_OUT_CHANNELS; i++) {
-        Channels[i] = MIXER_GetChannel(i, APPLY_ALL);
+        s32 value = MIXER_GetChannel(i, APPLY_ALL);
+        // Trims, limits and safety change the output without touching raw[]
+        if (Channels[i] != value) {
+            Channels[i] = value;
+            set_changed(NUM_INPUTS + 1 + i);
+        }
+    }
+}
+
+/* Copy the change bits gathered since the previous call into 'changed'
+ * (MIXER_CHANGE_WORDS long) and start over.  Only one consumer (the
+ * visible page) may call this. */
+void MIXER_TakeChanges(u32 *changed)
+{
+    unsigned bank = change_bank;
+    change_bank = ! bank;
+    for (int i = 0; i < MIXER_CHANGE_WORDS; i++) {
+        changed[i] = changes[bank][i];
+        changes[bank][i] = 0;
+    }
+    for (int i = 0; i < NUM_TRIMS; i++) {
+        int fired = (trim_changes >> i) & 1;
+        // A switched trim shows another value when its switch moves
+        for (int j = 0; ! fired && Model.trims[i].sw && j < 6; j++) {
+            unsigned sw = Model.trims[i].sw + j;
+            fired = sw <= NUM_SOURCES && MIXER_CHANGED(changed, sw);
+        }
+        if (fired)
+            changed[MIXER_CHANGE_TRIM(i) / 32] |= 1 << (MIXER_CHANGE_TRIM(i) % 32);
     }
+    trim_changes = 0;
 }
 
 volatile s32 *MIXER_GetInputs()
@@ -350,11 +408,7 @@ void MIXER_ApplyMixer(struct Mixer *mixer, volatile s32 *raw, s32 *orig_value)
             //rate represents the maximum travel per iteration (once per mixer_period)
             s32 rate = CHAN_MAX_VALUE * mixer_period / value;
 
-            value = scaled_value;
-            if (value - *orig_value > rate)
-                value = *orig_value + rate;
-            else if(value - *orig_value < -rate)
-                value = *orig_value - rate;
+            value = DSP_Slew(scaled_value, *orig_value, rate);
         }
         break;
 #if HAS_EXTENDED_AUDIO
@@ -433,10 +487,7 @@ s32 MIXER_ApplyLimits(unsigned channel, struct Limit *limit, volatile s32 *_raw,
         //degrees / 100msec
         if (_Channels && (flags & APPLY_SPEED) && limit->speed) {
             s32 rate = CHAN_MAX_VALUE * limit->speed / 60 * mixer_period / 100;
-            if (value - _Channels[channel] > rate)
-                value = _Channels[channel] + rate;
-            else if(value - _Channels[channel] < -rate)
-                value = _Channels[channel] - rate;
+            value = DSP_Slew(value, _Channels[channel], rate);
         }
     }
     if (flags & APPLY_LIMITS) {
@@ -801,6 +852,7 @@ unsigned MIXER_UpdateTrim(u32 buttons, unsigned flags, void *data)
         reach_end = 0;
         int neg_button = CHAN_ButtonIsPressed(buttons, Model.trims[i].neg);
         if (neg_button || CHAN_ButtonIsPressed(buttons, Model.trims[i].pos)) {
+            trim_changes |= 1 << i;
             if (Model.trims[i].step > TRIM_MAX_VALUE) {
                 _trim_as_switch(flags, i, neg_button);
                 continue;
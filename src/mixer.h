@@ -212,6 +212,12 @@ void MIXER_ApplyMixer(struct Mixer *mixer, volatile s32 *raw, s32 *orig_value);
 void MIXER_EvalMixers(volatile s32 *raw);
 int MIXER_GetCachedInputs(s32 *raw, unsigned threshold);
 
+/* Change notification: one bit per raw[] source, then one bit per trim */
+#define MIXER_CHANGE_TRIM(i) (NUM_SOURCES + 1 + (i))
+#define MIXER_CHANGE_WORDS ((NUM_SOURCES + 1 + NUM_TRIMS + 31) / 32)
+#define MIXER_CHANGED(changed, idx) (((changed)[(idx) / 32] >> ((idx) % 32)) & 1)
+void MIXER_TakeChanges(u32 *changed);
+
 struct Mixer *MIXER_GetAllMixers();
 
 struct Trim *MIXER_GetAllTrims();
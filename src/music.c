@@ -283,26 +283,26 @@ void MUSIC_PlayValue(u16 music, s32 value, u8 unit, u8 prec)
     if (unit == VOICE_UNIT_TIME) {
         if (value >= 3600) {
             i = value / 3600;
-            AUDIO_AddQueue(i + MUSIC_TOTAL);
-            AUDIO_AddQueue(VOICE_UNIT_HOURS + VOICE_UNIT_OFFSET);
+            AUDIO_AppendQueue(i + MUSIC_TOTAL);
+            AUDIO_AppendQueue(VOICE_UNIT_HOURS + VOICE_UNIT_OFFSET);
             value %= 3600;
         }
         if (value >= 60) {
             i = value / 60;
-            AUDIO_AddQueue(i + MUSIC_TOTAL);
-            AUDIO_AddQueue(VOICE_UNIT_MINUTES + VOICE_UNIT_OFFSET);
+            AUDIO_AppendQueue(i + MUSIC_TOTAL);
+            AUDIO_AppendQueue(VOICE_UNIT_MINUTES + VOICE_UNIT_OFFSET);
             value %= 60;
         }
         if (value > 0) {
-            AUDIO_AddQueue(value + MUSIC_TOTAL);
-            AUDIO_AddQueue(VOICE_UNIT_SECONDS + VOICE_UNIT_OFFSET);
+            AUDIO_AppendQueue(value + MUSIC_TOTAL);
+            AUDIO_AppendQueue(VOICE_UNIT_SECONDS + VOICE_UNIT_OFFSET);
         }
         return;
     }
 
     // Add minus sign for negative number
     if (value < 0) {
-        AUDIO_AddQueue(VOICE_UNIT_MINUS + VOICE_UNIT_OFFSET);
+        AUDIO_AppendQueue(VOICE_UNIT_MINUS + VOICE_UNIT_OFFSET);
         value *= -1;
     }
 
@@ -349,11 +349,11 @@ void MUSIC_PlayValue(u16 music, s32 value, u8 unit, u8 prec)
 
     // Fill music queue with digits
     for (i = digit_count; i > 0; i--) {
-        AUDIO_AddQueue(digits[i-1] + MUSIC_TOTAL);
+        AUDIO_AppendQueue(digits[i-1] + MUSIC_TOTAL);
     }
     // Add unit for value if specified
     if (unit > VOICE_UNIT_NONE)
-        AUDIO_AddQueue(unit + VOICE_UNIT_OFFSET);
+        AUDIO_AppendQueue(unit + VOICE_UNIT_OFFSET);
 }
 #endif
 #define TESTNAME music
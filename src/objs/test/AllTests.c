@@ -0,0 +1,237 @@
+
+
+/* This is auto-generated code. Edit at your own peril. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "CuTest.h"
+
+
+extern void TestCuStringNew(CuTest*);
+extern void TestCuStringAppend(CuTest*);
+extern void TestCuStringAppendNULL(CuTest*);
+extern void TestCuStringAppendChar(CuTest*);
+extern void TestCuStringInserts(CuTest*);
+extern void TestCuStringResizes(CuTest*);
+extern void TestPasses(CuTest*);
+extern void TestCuTestNew(CuTest*);
+extern void TestCuTestInit(CuTest*);
+extern void TestCuAssert(CuTest*);
+extern void TestCuAssertPtrEquals_Success(CuTest*);
+extern void TestCuAssertPtrEquals_Failure(CuTest*);
+extern void TestCuAssertPtrNotNull_Success(CuTest*);
+extern void TestCuAssertPtrNotNull_Failure(CuTest*);
+extern void TestCuTestRun(CuTest*);
+extern void TestCuSuiteInit(CuTest*);
+extern void TestCuSuiteNew(CuTest*);
+extern void TestCuSuiteAddTest(CuTest*);
+extern void TestCuSuiteAddSuite(CuTest*);
+extern void TestCuSuiteRun(CuTest*);
+extern void TestCuSuiteSummary(CuTest*);
+extern void TestCuSuiteDetails_SingleFail(CuTest*);
+extern void TestCuSuiteDetails_SinglePass(CuTest*);
+extern void TestCuSuiteDetails_MultiplePasses(CuTest*);
+extern void TestCuSuiteDetails_MultipleFails(CuTest*);
+extern void TestCuStrCopy(CuTest*);
+extern void TestCuStringAppendFormat(CuTest*);
+extern void TestFail(CuTest*);
+extern void TestAssertStrEquals(CuTest*);
+extern void TestAssertStrEquals_NULL(CuTest*);
+extern void TestAssertStrEquals_FailNULLStr(CuTest*);
+extern void TestAssertStrEquals_FailStrNULL(CuTest*);
+extern void TestAssertIntEquals(CuTest*);
+extern void TestAssertDblEquals(CuTest*);
+extern void TestAdpcmDecode(CuTest*);
+extern void TestBlockCacheRead(CuTest*);
+extern void TestBlockCacheReplacement(CuTest*);
+extern void TestButtonDispatch(CuTest*);
+extern void TestButtonDebounce(CuTest*);
+extern void TestFontLoad(CuTest*);
+extern void TestFontRender(CuTest*);
+extern void TestDspCalibrate(CuTest*);
+extern void TestDspFilters(CuTest*);
+extern void TestAudioQueueCoalesce(CuTest*);
+extern void TestAudioQueueFull(CuTest*);
+extern void TestAudioQueuePriority(CuTest*);
+extern void TestLabel(CuTest*);
+extern void TestXYGraphPartialRedraw(CuTest*);
+extern void TestIniParse(CuTest*);
+extern void TestIniParseLongLines(CuTest*);
+extern void TestImageCacheWindows(CuTest*);
+extern void TestImageCacheOverflow(CuTest*);
+extern void TestGetAllMixers(CuTest*);
+extern void TestGetAllTrims(CuTest*);
+extern void TestMixerInit(CuTest*);
+extern void TestEvalMixers(CuTest*);
+extern void TestMixerMapChannel(CuTest*);
+extern void TestUpdateRawInputs(CuTest*);
+extern void TestGetCachedInputs(CuTest*);
+extern void TestCalcChannels(CuTest*);
+extern void TestTakeChanges(CuTest*);
+extern void TestGetInputs(CuTest*);
+extern void TestGetChannel(CuTest*);
+extern void TestGetChannelDisplayScale(CuTest*);
+extern void TestGetChannelDisplayFormat(CuTest*);
+extern void TestCreateCyclicOutput(CuTest*);
+extern void TestApplyMixerSimple(CuTest*);
+extern void TestApplyMixerDelay(CuTest*);
+extern void TestApplyMixerTrim(CuTest*);
+extern void TestApplyLimits(CuTest*);
+extern void TestGetTrim(CuTest*);
+extern void TestGetSetTemplate(CuTest*);
+extern void TestUpdateTrim(CuTest*);
+extern void TestTrimAsSwitch(CuTest*);
+extern void TestSetMixers(CuTest*);
+extern void TestSetMixerDepends(CuTest*);
+extern void TestSetMixerLoop(CuTest*);
+extern void TestGetLimit(CuTest*);
+extern void TestInitMixer(CuTest*);
+extern void TestSourceHasTrim(CuTest*);
+extern void TestTemplateName(CuTest*);
+extern void TestSwashType(CuTest*);
+extern void TestGetSourceVal(CuTest*);
+extern void TestSourceAsBoolean(CuTest*);
+extern void TestModelLoadSave(CuTest*);
+extern void TestModelLoadSaveWithLoc(CuTest*);
+extern void TestModelChange(CuTest*);
+extern void TestModelCrc(CuTest*);
+extern void TestModelChangeScan(CuTest*);
+extern void TestModelSourceNames(CuTest*);
+extern void TestMusic(CuTest*);
+extern void TestAllPages(CuTest*);
+extern void TestMainPageToggleReinit(CuTest*);
+extern void TestMixerPageReorder(CuTest*);
+extern void TestPetitFatFastSeek(CuTest*);
+extern void TestPetitFatSeekPastMap(CuTest*);
+extern void TestProtocolTraces(CuTest*);
+extern void TestLz4Decompress(CuTest*);
+extern void TestTelemetryAlarmHysteresis(CuTest*);
+extern void TestTelemetryUpdatedQueue(CuTest*);
+extern void TestTelemetryHistory(CuTest*);
+
+
+int RunAllTests(void)
+{
+    CuString *output = CuStringNew();
+    CuSuite* suite = CuSuiteNew();
+
+
+    SUITE_ADD_TEST(suite, TestCuStringNew);
+    SUITE_ADD_TEST(suite, TestCuStringAppend);
+    SUITE_ADD_TEST(suite, TestCuStringAppendNULL);
+    SUITE_ADD_TEST(suite, TestCuStringAppendChar);
+    SUITE_ADD_TEST(suite, TestCuStringInserts);
+    SUITE_ADD_TEST(suite, TestCuStringResizes);
+    SUITE_ADD_TEST(suite, TestPasses);
+    SUITE_ADD_TEST(suite, TestCuTestNew);
+    SUITE_ADD_TEST(suite, TestCuTestInit);
+    SUITE_ADD_TEST(suite, TestCuAssert);
+    SUITE_ADD_TEST(suite, TestCuAssertPtrEquals_Success);
+    SUITE_ADD_TEST(suite, TestCuAssertPtrEquals_Failure);
+    SUITE_ADD_TEST(suite, TestCuAssertPtrNotNull_Success);
+    SUITE_ADD_TEST(suite, TestCuAssertPtrNotNull_Failure);
+    SUITE_ADD_TEST(suite, TestCuTestRun);
+    SUITE_ADD_TEST(suite, TestCuSuiteInit);
+    SUITE_ADD_TEST(suite, TestCuSuiteNew);
+    SUITE_ADD_TEST(suite, TestCuSuiteAddTest);
+    SUITE_ADD_TEST(suite, TestCuSuiteAddSuite);
+    SUITE_ADD_TEST(suite, TestCuSuiteRun);
+    SUITE_ADD_TEST(suite, TestCuSuiteSummary);
+    SUITE_ADD_TEST(suite, TestCuSuiteDetails_SingleFail);
+    SUITE_ADD_TEST(suite, TestCuSuiteDetails_SinglePass);
+    SUITE_ADD_TEST(suite, TestCuSuiteDetails_MultiplePasses);
+    SUITE_ADD_TEST(suite, TestCuSuiteDetails_MultipleFails);
+    SUITE_ADD_TEST(suite, TestCuStrCopy);
+    SUITE_ADD_TEST(suite, TestCuStringAppendFormat);
+    SUITE_ADD_TEST(suite, TestFail);
+    SUITE_ADD_TEST(suite, TestAssertStrEquals);
+    SUITE_ADD_TEST(suite, TestAssertStrEquals_NULL);
+    SUITE_ADD_TEST(suite, TestAssertStrEquals_FailNULLStr);
+    SUITE_ADD_TEST(suite, TestAssertStrEquals_FailStrNULL);
+    SUITE_ADD_TEST(suite, TestAssertIntEquals);
+    SUITE_ADD_TEST(suite, TestAssertDblEquals);
+    SUITE_ADD_TEST(suite, TestAdpcmDecode);
+    SUITE_ADD_TEST(suite, TestBlockCacheRead);
+    SUITE_ADD_TEST(suite, TestBlockCacheReplacement);
+    SUITE_ADD_TEST(suite, TestButtonDispatch);
+    SUITE_ADD_TEST(suite, TestButtonDebounce);
+    SUITE_ADD_TEST(suite, TestFontLoad);
+    SUITE_ADD_TEST(suite, TestFontRender);
+    SUITE_ADD_TEST(suite, TestDspCalibrate);
+    SUITE_ADD_TEST(suite, TestDspFilters);
+    SUITE_ADD_TEST(suite, TestAudioQueueCoalesce);
+    SUITE_ADD_TEST(suite, TestAudioQueueFull);
+    SUITE_ADD_TEST(suite, TestAudioQueuePriority);
+    SUITE_ADD_TEST(suite, TestLabel);
+    SUITE_ADD_TEST(suite, TestXYGraphPartialRedraw);
+    SUITE_ADD_TEST(suite, TestIniParse);
+    SUITE_ADD_TEST(suite, TestIniParseLongLines);
+    SUITE_ADD_TEST(suite, TestImageCacheWindows);
+    SUITE_ADD_TEST(suite, TestImageCacheOverflow);
+    SUITE_ADD_TEST(suite, TestGetAllMixers);
+    SUITE_ADD_TEST(suite, TestGetAllTrims);
+    SUITE_ADD_TEST(suite, TestMixerInit);
+    SUITE_ADD_TEST(suite, TestEvalMixers);
+    SUITE_ADD_TEST(suite, TestMixerMapChannel);
+    SUITE_ADD_TEST(suite, TestUpdateRawInputs);
+    SUITE_ADD_TEST(suite, TestGetCachedInputs);
+    SUITE_ADD_TEST(suite, TestCalcChannels);
+    SUITE_ADD_TEST(suite, TestTakeChanges);
+    SUITE_ADD_TEST(suite, TestGetInputs);
+    SUITE_ADD_TEST(suite, TestGetChannel);
+    SUITE_ADD_TEST(suite, TestGetChannelDisplayScale);
+    SUITE_ADD_TEST(suite, TestGetChannelDisplayFormat);
+    SUITE_ADD_TEST(suite, TestCreateCyclicOutput);
+    SUITE_ADD_TEST(suite, TestApplyMixerSimple);
+    SUITE_ADD_TEST(suite, TestApplyMixerDelay);
+    SUITE_ADD_TEST(suite, TestApplyMixerTrim);
+    SUITE_ADD_TEST(suite, TestApplyLimits);
+    SUITE_ADD_TEST(suite, TestGetTrim);
+    SUITE_ADD_TEST(suite, TestGetSetTemplate);
+    SUITE_ADD_TEST(suite, TestUpdateTrim);
+    SUITE_ADD_TEST(suite, TestTrimAsSwitch);
+    SUITE_ADD_TEST(suite, TestSetMixers);
+    SUITE_ADD_TEST(suite, TestSetMixerDepends);
+    SUITE_ADD_TEST(suite, TestSetMixerLoop);
+    SUITE_ADD_TEST(suite, TestGetLimit);
+    SUITE_ADD_TEST(suite, TestInitMixer);
+    SUITE_ADD_TEST(suite, TestSourceHasTrim);
+    SUITE_ADD_TEST(suite, TestTemplateName);
+    SUITE_ADD_TEST(suite, TestSwashType);
+    SUITE_ADD_TEST(suite, TestGetSourceVal);
+    SUITE_ADD_TEST(suite, TestSourceAsBoolean);
+    SUITE_ADD_TEST(suite, TestModelLoadSave);
+    SUITE_ADD_TEST(suite, TestModelLoadSaveWithLoc);
+    SUITE_ADD_TEST(suite, TestModelChange);
+    SUITE_ADD_TEST(suite, TestModelCrc);
+    SUITE_ADD_TEST(suite, TestModelChangeScan);
+    SUITE_ADD_TEST(suite, TestModelSourceNames);
+    SUITE_ADD_TEST(suite, TestMusic);
+    SUITE_ADD_TEST(suite, TestAllPages);
+    SUITE_ADD_TEST(suite, TestMainPageToggleReinit);
+    SUITE_ADD_TEST(suite, TestMixerPageReorder);
+    SUITE_ADD_TEST(suite, TestPetitFatFastSeek);
+    SUITE_ADD_TEST(suite, TestPetitFatSeekPastMap);
+    SUITE_ADD_TEST(suite, TestProtocolTraces);
+    SUITE_ADD_TEST(suite, TestLz4Decompress);
+    SUITE_ADD_TEST(suite, TestTelemetryAlarmHysteresis);
+    SUITE_ADD_TEST(suite, TestTelemetryUpdatedQueue);
+    SUITE_ADD_TEST(suite, TestTelemetryHistory);
+
+    CuSuiteRun(suite);
+    CuSuiteSummary(suite, output);
+    CuSuiteDetails(suite, output);
+    printf("%s\n", output->buffer);
+    CuStringDelete(output);
+    CuSuiteDelete(suite);
+    return suite->failCount;
+}
+
+int main(void)
+{
+    chdir(FILESYSTEM_DIR);
+    return RunAllTests();
+}
+
+
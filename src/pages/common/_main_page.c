@@ -138,6 +138,67 @@ s32 bar_cb(void * data)
     return MIXER_GetChannel(idx-1, APPLY_SAFETY);
 }
 
+/* The icon toggle element i shows for the current state of its source,
+ * or -1 if it is hidden */
+static int _toggle_icon(int i)
+{
+    volatile s32 *raw = MIXER_GetInputs();
+    int src = MIXER_SRC(pc->elem[i].src);
+    if (! src)
+        return -1;
+    if (src > INP_HAS_CALIBRATION && src < INP_LAST) {
+        //switch
+        for (int j = 0; j < 3; j++) {
+            // Assume switch 0/1/2 are in order
+            if(ELEM_ICO(pc->elem[i], j) && raw[src+j] > 0)
+                return ELEM_ICO(pc->elem[i], j);
+        }
+        return -1;
+    }
+    //Non switch
+    int sw = raw[src] > 0 ? 1 : 0;
+    return ELEM_ICO(pc->elem[i], sw) ? ELEM_ICO(pc->elem[i], sw) : -1;
+}
+
+/* Whether a source shown by element i fired since the previous tick */
+static int _elem_changed(int i, const u32 *changed, unsigned timers, const u32 *telem)
+{
+    int src = pc->elem[i].src;
+    switch(ELEM_TYPE(pc->elem[i])) {
+        case ELEM_VTRIM:
+        case ELEM_HTRIM:
+            return MIXER_CHANGED(changed, MIXER_CHANGE_TRIM(src - 1));
+        case ELEM_SMALLBOX:
+        case ELEM_BIGBOX:
+#if HAS_RTC
+            if (src <= NUM_RTC)
+                return 1;
+#endif
+            if (src - NUM_RTC <= NUM_TIMERS)
+                return (timers >> (src - NUM_RTC - 1)) & 1;
+            if (src - NUM_RTC - NUM_TIMERS <= NUM_TELEM) {
+                src -= NUM_RTC + NUM_TIMERS;
+                return (telem[0] & 1) || ((telem[src / 32] >> (src % 32)) & 1);
+            }
+            return MIXER_CHANGED(changed, src - (NUM_RTC + NUM_TIMERS + NUM_TELEM + 1) + NUM_INPUTS + 1);
+        case ELEM_BAR:
+            return MIXER_CHANGED(changed, src + NUM_INPUTS);
+        case ELEM_TOGGLE:
+            src = MIXER_SRC(src);
+            if (! src)
+                return 0;
+            if (src > INP_HAS_CALIBRATION && src < INP_LAST) {
+                for (int j = 0; j < 3; j++) {
+                    if (MIXER_CHANGED(changed, src + j))
+                        return 1;
+                }
+                return 0;
+            }
+            return MIXER_CHANGED(changed, src);
+    }
+    return 1;
+}
+
 void PAGE_MainEvent()
 {
     int i;
@@ -149,12 +210,18 @@ void PAGE_MainEvent()
 #endif
         return;
     }
-    volatile s32 *raw = MIXER_GetInputs();
+    u32 changed[MIXER_CHANGE_WORDS];
+    u32 telem[TELEM_UPDATE_SIZE];
+    MIXER_TakeChanges(changed);
+    TELEMETRY_TakeChanges(telem);
+    unsigned timers = TIMER_TakeChanges();
     for(i = 0; i < NUM_ELEMS; i++) {
         if (! ELEM_USED(pc->elem[i]))
             break;
         if (! OBJ_IS_USED(&gui->elem[i]))
             continue;
+        if (! mp->refresh && ! _elem_changed(i, changed, timers, telem))
+            continue;
         int src = pc->elem[i].src;
         int type = ELEM_TYPE(pc->elem[i]);
         switch(type) {
@@ -218,26 +285,10 @@ void PAGE_MainEvent()
             }
             case ELEM_TOGGLE:
             {
-                src = MIXER_SRC(src);
-                int idx = -1;
-                if(src) {
-                    if (src > INP_HAS_CALIBRATION && src < INP_LAST) {
-                        //switch
-                        for (int j = 0; j < 3; j++) {
-                            // Assume switch 0/1/2 are in order
-                            if(ELEM_ICO(pc->elem[i], j) && raw[src+j] > 0) {
-                                idx = ELEM_ICO(pc->elem[i], j);
-                                break;
-                            }
-                        }
-                    } else {
-                        //Non switch
-                        int sw = raw[src] > 0 ? 1 : 0;
-                        if (ELEM_ICO(pc->elem[i], sw)) {
-                            idx = ELEM_ICO(pc->elem[i], sw);
-                        }
-                    }
-                }
+                int idx = _toggle_icon(i);
+                if (idx == mp->elem[i])
+                    break;
+                mp->elem[i] = idx;
                 if (idx != -1) {
 #ifdef HAS_CHAR_ICONS
                     GUI_SetHidden((guiObject_t *)&gui->elem[i], 1);
@@ -258,6 +309,7 @@ void PAGE_MainEvent()
                 break;
         }
     }
+    mp->refresh = 0;
     if(HAS_TOUCH)  //FIXME: Hack to let 320x240 GUI continue to work
         _check_voltage(NULL);
 #if HAS_RTC
@@ -405,14 +457,16 @@ void show_elements()
             }
             case ELEM_TOGGLE:
             {
+                int idx = _toggle_icon(i);
+                mp->elem[i] = idx;
 #ifdef HAS_CHAR_ICONS
-                GUI_CreateLabelBox(&gui->elem[i].box, x, y, 2, 2, &DEFAULT_FONT, TGLICO_font_cb, NULL, (void *)(long)ELEM_ICO(pc->elem[i], 0));
-                GUI_SetHidden((guiObject_t *)&gui->elem[i], 1);
+                GUI_CreateLabelBox(&gui->elem[i].box, x, y, 2, 2, &DEFAULT_FONT, TGLICO_font_cb, NULL, (void *)(long)idx);
 #else
-                struct ImageMap img = TGLICO_GetImage(ELEM_ICO(pc->elem[i], 0)); //We'll set this properly down below
+                struct ImageMap img = TGLICO_GetImage(idx != -1 ? idx : 0);
                 GUI_CreateImageOffset(&gui->elem[i].img, x, y, w, h,
                                   img.x_off, img.y_off, img.file, NULL, NULL);
 #endif
+                GUI_SetHidden((guiObject_t *)&gui->elem[i], idx == -1);
                 break;
             }
             case ELEM_BATTERY:
@@ -423,4 +477,7 @@ void show_elements()
                 break; 
         }
     }
+    // Element states such as telemetry alarm fonts are only set up by
+    // PAGE_MainEvent(), and their sources may not change for a long time
+    mp->refresh = 1;
 }
@@ -404,7 +404,7 @@ static const char *_audio_vol_cb(guiObject_t *obj, int dir, void *data)
         *unsigned_data = GUI_TextSelectHelper(*unsigned_data, 0, 10, dir, 1, 5, &changed);
         if (changed) {
             AUDIO_SetVolume();
-            if (!num_audio)
+            if (!AUDIO_Busy())
                 MUSIC_Play(MUSIC_VOLUME);
         }
     }
@@ -5,6 +5,7 @@
 struct main_page {
     struct buttonAction action;
     u8 ignore_release;
+    u8 refresh;  // evaluate every element on the next event
     s16 battery;
     s32 elem[NUM_ELEMS];
 #if HAS_RTC
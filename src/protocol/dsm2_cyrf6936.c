@@ -171,8 +171,15 @@ static const u8 ch_map12[] = {1, 5, 2, 4, 6, 10, 0xff,    0, 7, 3, 8, 9, 11, 0xf
 static const u8 ch_map14[] = {1, 5, 2, 3, 4,  6,    8,    1, 5, 2, 3, 0,  7,    9};
 #endif
 
+// Last eight data code bytes of PN row 3 / column 7 differ for OrangeRX receivers
+static const u8 orangerx_data_code[16] = {
+    0x35, 0xD1, 0xFC, 0x97, 0x23, 0xD4, 0xC9, 0x88,
+    0x88, 0xE1, 0xD6, 0x31, 0x26, 0x5F, 0xBD, 0x40
+};
+
 static u8 packet[16];
 static u8 channels[23];
+static struct cyrf_hop pn_hops[5];  // SOP/data codes for each PN row
 static u8 chidx;
 static u8 sop_col;
 static u8 data_col;
@@ -374,20 +381,23 @@ static u8 get_pn_row(u8 channel)
            : channel % 5;
 }
 
-static void set_sop_data_crc()
+static void init_pn_hops()
 {
-    u8 pn_row = get_pn_row(channels[chidx]);
-    //printf("Ch: %d Row: %d SOP: %d Data: %d\n", ch[chidx], pn_row, sop_col, data_col);
-    CYRF_WriteRegister(CYRF_00_CHANNEL, channels[chidx]);
-    CYRF_ConfigCRCSeed(crcidx ? ~crc : crc);
-    CYRF_ConfigSOPCode(pncodes[pn_row][sop_col]);
-    //In 64-8DR mode, all sixteen bytes are used
-    CYRF_ConfigDataCode(pncodes[pn_row][data_col], 8); //first eight bytes
-    if((pn_row == 3) && (data_col == 7) && (Model.proto_opts[PROTOOPTS_ORANGERX] == ORANGERX_YES)) {
-        CYRF_ConfigDataCode((const u8 *)"\x88\xE1\xD6\x31\x26\x5F\xBD\x40", 8); //last eight bytes
-    } else {
-        CYRF_ConfigDataCode(pncodes[pn_row][data_col + 1], 8); //last eight bytes
+    for (u32 row = 0; row < 5; row++) {
+        pn_hops[row].sop_code = pncodes[row][sop_col];
+        //In 64-8DR mode, all sixteen bytes are used
+        pn_hops[row].data_code = pncodes[row][data_col];
     }
+    if (data_col == 7 && Model.proto_opts[PROTOOPTS_ORANGERX] == ORANGERX_YES)
+        pn_hops[3].data_code = orangerx_data_code;
+}
+
+static void set_sop_data_crc()
+{
+    struct cyrf_hop *hop = &pn_hops[get_pn_row(channels[chidx])];
+    hop->channel = channels[chidx];
+    hop->crc_seed = crcidx ? ~crc : crc;
+    CYRF_ConfigHop(hop);
     /* setup for next iteration */
     if(Model.protocol == PROTOCOL_DSMX)
         chidx = (chidx + 1) % 23;
@@ -874,6 +884,7 @@ static void initialize(u8 bind)
     crcidx = 0;
     sop_col = (cyrfmfg_id[0] + cyrfmfg_id[1] + cyrfmfg_id[2] + 2) & 0x07;
     data_col = 7 - sop_col;
+    init_pn_hops();
     model = MODEL;
     num_channels = Model.num_channels;
 #ifndef MODULAR
@@ -912,6 +923,9 @@ uintptr_t DSM2_Cmds(enum ProtoCmds cmd)
         case PROTOCMD_CURRENT_ID: return Model.fixed_id;
         case PROTOCMD_GETOPTIONS:
             return (uintptr_t)dsm_opts;
+        case PROTOCMD_SETOPTIONS:
+            init_pn_hops();  // OrangeRX data code
+            return 0;
         case PROTOCMD_TELEMETRYSTATE:
             return (Model.proto_opts[PROTOOPTS_TELEMETRY] == TELEM_ON ? PROTO_TELEM_ON : PROTO_TELEM_OFF);
         case PROTOCMD_TELEMETRYTYPE: 
@@ -54,7 +54,7 @@ ctassert(LAST_PROTO_OPT <= NUM_PROTO_OPTS, too_many_protocol_opts);
 
 // Statics are not initialized on 7e so in initialize() if necessary
 static u8 chanskip;
-static u8 calData[48][3];
+static u8 hop_regs[48][CC2500_HOP_LEN];
 static u8 channr;
 static u8 counter_rst;
 static u8 ctr;
@@ -161,14 +161,7 @@ static void initialize_data(u8 adr)
 
 
 static void set_start(u8 ch) {
-  CC2500_Strobe(CC2500_SIDLE);
-  CC2500_WriteReg(CC2500_23_FSCAL3, calData[ch][0]);
-  CC2500_WriteReg(CC2500_24_FSCAL2, calData[ch][1]);
-  CC2500_WriteReg(CC2500_25_FSCAL1, calData[ch][2]);
-  if (!Model.proto_opts[PROTO_OPTS_VERSION])
-      CC2500_WriteReg(CC2500_0A_CHANNR, ch == 47 ? 0 : hop_data[ch]);
-  else
-      CC2500_WriteReg(CC2500_0A_CHANNR, hop_data_v2[ch]);
+  CC2500_ConfigHop(hop_regs[ch]);
 }
 
 #define RXNUM 16
@@ -574,59 +567,88 @@ static u16 frskyx_cb() {
   return 1;
 }
 
-// register, FCC, EU
-static const u8 init_data[][3] = {
-    {CC2500_02_IOCFG0,    0x06,  0x06},
-    {CC2500_00_IOCFG2,    0x06,  0x06},
-    {CC2500_17_MCSM1,     0x0c,  0x0E},
-    {CC2500_18_MCSM0,     0x18,  0x18},
-    {CC2500_06_PKTLEN,    0x1E,  0x23},
-    {CC2500_07_PKTCTRL1,  0x04,  0x04},
-    {CC2500_08_PKTCTRL0,  0x01,  0x01},
-    {CC2500_3E_PATABLE,   0xff,  0xff},
-    {CC2500_0B_FSCTRL1,   0x0A,  0x08},
-    {CC2500_0C_FSCTRL0,   0x00,  0x00},
-    {CC2500_0D_FREQ2,     0x5c,  0x5c},
-    {CC2500_0E_FREQ1,     0x76,  0x80},
-    {CC2500_0F_FREQ0,     0x27,  0x00},
-    {CC2500_10_MDMCFG4,   0x7B,  0x7B},
-    {CC2500_11_MDMCFG3,   0x61,  0xF8},
-    {CC2500_12_MDMCFG2,   0x13,  0x03},
-    {CC2500_13_MDMCFG1,   0x23,  0x23},
-    {CC2500_14_MDMCFG0,   0x7a,  0x7a},
-    {CC2500_15_DEVIATN,   0x51,  0x53},
+static const u8 init_script[] = {
+    CC2500_SCRIPT_RUN(CC2500_00_IOCFG2, 1),
+        0x06,
+    CC2500_SCRIPT_RUN(CC2500_02_IOCFG0, 2),
+        0x06,  // IOCFG0
+        0x07,  // FIFOTHR
+    CC2500_SCRIPT_RUN(CC2500_07_PKTCTRL1, 3),
+        0x04,  // PKTCTRL1
+        0x01,  // PKTCTRL0
+        0x00,  // ADDR
+    CC2500_SCRIPT_RUN(CC2500_18_MCSM0, 6),
+        0x18,  // MCSM0
+        0x16,  // FOCCFG
+        0x6c,  // BSCFG
+        0x43,  // AGCCTRL2
+        0x40,  // AGCCTRL1
+        0x91,  // AGCCTRL0
+    CC2500_SCRIPT_RUN(CC2500_21_FREND1, 6),
+        0x56,  // FREND1
+        0x10,  // FREND0
+        0xa9,  // FSCAL3
+        0x0A,  // FSCAL2
+        0x00,  // FSCAL1
+        0x11,  // FSCAL0
+    CC2500_SCRIPT_RUN(CC2500_29_FSTEST, 1),
+        0x59,
+    CC2500_SCRIPT_RUN(CC2500_2C_TEST2, 3),
+        0x88,  // TEST2
+        0x31,  // TEST1
+        0x0B,  // TEST0
+    CC2500_SCRIPT_RUN(CC2500_3E_PATABLE, 1),
+        0xff,
+    CC2500_SCRIPT_END
 };
 
-// register, value
-static const u8 init_data_shared[][2] = {
-    {CC2500_19_FOCCFG,    0x16},
-    {CC2500_1A_BSCFG,     0x6c},
-    {CC2500_1B_AGCCTRL2,  0x43},
-    {CC2500_1C_AGCCTRL1,  0x40},
-    {CC2500_1D_AGCCTRL0,  0x91},
-    {CC2500_21_FREND1,    0x56},
-    {CC2500_22_FREND0,    0x10},
-    {CC2500_23_FSCAL3,    0xa9},
-    {CC2500_24_FSCAL2,    0x0A},
-    {CC2500_25_FSCAL1,    0x00},
-    {CC2500_26_FSCAL0,    0x11},
-    {CC2500_29_FSTEST,    0x59},
-    {CC2500_2C_TEST2,     0x88},
-    {CC2500_2D_TEST1,     0x31},
-    {CC2500_2E_TEST0,     0x0B},
-    {CC2500_03_FIFOTHR,   0x07},
-    {CC2500_09_ADDR,      0x00},
+// Registers that differ between the FCC and EU formats
+static const u8 init_script_format[][24] = {
+  { // FCC
+    CC2500_SCRIPT_RUN(CC2500_06_PKTLEN, 1),
+        0x1E,
+    CC2500_SCRIPT_RUN(CC2500_0B_FSCTRL1, 11),
+        0x0A,  // FSCTRL1
+        0x00,  // FSCTRL0
+        0x5c,  // FREQ2
+        0x76,  // FREQ1
+        0x27,  // FREQ0
+        0x7B,  // MDMCFG4
+        0x61,  // MDMCFG3
+        0x13,  // MDMCFG2
+        0x23,  // MDMCFG1
+        0x7a,  // MDMCFG0
+        0x51,  // DEVIATN
+    CC2500_SCRIPT_RUN(CC2500_17_MCSM1, 1),
+        0x0c,
+    CC2500_SCRIPT_END
+  },
+  { // EU
+    CC2500_SCRIPT_RUN(CC2500_06_PKTLEN, 1),
+        0x23,
+    CC2500_SCRIPT_RUN(CC2500_0B_FSCTRL1, 11),
+        0x08,  // FSCTRL1
+        0x00,  // FSCTRL0
+        0x5c,  // FREQ2
+        0x80,  // FREQ1
+        0x00,  // FREQ0
+        0x7B,  // MDMCFG4
+        0xF8,  // MDMCFG3
+        0x03,  // MDMCFG2
+        0x23,  // MDMCFG1
+        0x7a,  // MDMCFG0
+        0x53,  // DEVIATN
+    CC2500_SCRIPT_RUN(CC2500_17_MCSM1, 1),
+        0x0E,
+    CC2500_SCRIPT_END
+  },
 };
 
 static void frskyX_init() {
   CC2500_Reset();
 
-  u8 format = Model.proto_opts[PROTO_OPTS_FORMAT] + 1;
-
-  for (u32 i = 0; i < ((sizeof init_data) / (sizeof init_data[0])); i++)
-      CC2500_WriteReg(init_data[i][0], init_data[i][format]);
-  for (u32 i = 0; i < ((sizeof init_data_shared) / (sizeof init_data_shared[0])); i++)
-      CC2500_WriteReg(init_data_shared[i][0], init_data_shared[i][1]);
+  CC2500_WriteRegisterScript(init_script);
+  CC2500_WriteRegisterScript(init_script_format[Model.proto_opts[PROTO_OPTS_FORMAT]]);
 
   if (Model.proto_opts[PROTO_OPTS_VERSION]) {
       CC2500_WriteReg(CC2500_08_PKTCTRL0, 0x05);                // Enable CRC
@@ -643,24 +665,22 @@ static void frskyX_init() {
   for (u8 c = 0; c < (HOP_DATA_SIZE - 1); c++) {
       CC2500_Strobe(CC2500_SIDLE);
       if (!Model.proto_opts[PROTO_OPTS_VERSION]) {
-          CC2500_WriteReg(CC2500_0A_CHANNR, hop_data[c]);
+          hop_regs[c][CC2500_HOP_CHANNR] = hop_data[c];
       } else {
           init_hop_FRSkyX2();
-          CC2500_WriteReg(CC2500_0A_CHANNR, hop_data_v2[c]);
+          hop_regs[c][CC2500_HOP_CHANNR] = hop_data_v2[c];
       }
+      CC2500_WriteReg(CC2500_0A_CHANNR, hop_regs[c][CC2500_HOP_CHANNR]);
       CC2500_Strobe(CC2500_SCAL);
       usleep(900);
-      calData[c][0] = CC2500_ReadReg(CC2500_23_FSCAL3);
-      calData[c][1] = CC2500_ReadReg(CC2500_24_FSCAL2);
-      calData[c][2] = CC2500_ReadReg(CC2500_25_FSCAL1);
+      CC2500_ReadRegisterMulti(CC2500_23_FSCAL3, &hop_regs[c][CC2500_HOP_FSCAL3], 3);
   }
   CC2500_Strobe(CC2500_SIDLE);
   CC2500_WriteReg(CC2500_0A_CHANNR, 0x00);
   CC2500_Strobe(CC2500_SCAL);
   usleep(900);
-  calData[HOP_DATA_SIZE - 1][0] = CC2500_ReadReg(CC2500_23_FSCAL3);
-  calData[HOP_DATA_SIZE - 1][1] = CC2500_ReadReg(CC2500_24_FSCAL2);
-  calData[HOP_DATA_SIZE - 1][2] = CC2500_ReadReg(CC2500_25_FSCAL1);
+  CC2500_ReadRegisterMulti(CC2500_23_FSCAL3, &hop_regs[HOP_DATA_SIZE - 1][CC2500_HOP_FSCAL3], 3);
+  hop_regs[HOP_DATA_SIZE - 1][CC2500_HOP_CHANNR] = 0x00;  // Bind channel
 }
 
 
@@ -125,11 +125,28 @@ enum {
 #define CC2500_LQI_CRC_OK_BM                   0x80
 #define CC2500_LQI_EST_BM                      0x7F
 
+// Register script: each run names its first register and the number of
+// values that follow, and is written as a single burst.
+#define CC2500_SCRIPT_RUN(addr, count)  (addr), (count)
+#define CC2500_SCRIPT_END               0x00, 0x00
+
+// Per-hop register bundle written by CC2500_ConfigHop(), the calibration
+// values come first so they can be read back with one FSCAL3 burst
+enum {
+    CC2500_HOP_FSCAL3,
+    CC2500_HOP_FSCAL2,
+    CC2500_HOP_FSCAL1,
+    CC2500_HOP_CHANNR,
+    CC2500_HOP_LEN,
+};
+
 void CC2500_WriteReg(u8 addr, u8 data);
 u8 CC2500_ReadReg(u8 addr);
 int CC2500_Reset();
 void CC2500_Strobe(u8 cmd);
 void CC2500_WriteRegisterMulti(u8 address, const u8 data[], u8 length);
+void CC2500_WriteRegisterScript(const u8 *script);
+void CC2500_ConfigHop(const u8 *hop);
 void CC2500_ReadRegisterMulti(u8 address, u8 data[], u8 length);
 void CC2500_WriteData(u8 *packet, u8 length);
 void CC2500_ReadData(u8 *dpbuffer, int len);
@@ -50,6 +50,14 @@ enum {
     CYRF_39_ANALOG_CTRL    = 0x39,
 };
 
+/* Radio setup for one frequency hop, written by CYRF_ConfigHop() */
+struct cyrf_hop {
+    const u8 *sop_code;   // 8 bytes
+    const u8 *data_code;  // 16 bytes (64-8DR mode)
+    u16 crc_seed;
+    u8 channel;
+};
+
 enum CYRF_PWR {
     CYRF_PWR_100MW,
     CYRF_PWR_10MW,
@@ -68,6 +76,7 @@ void CYRF_ConfigCRCSeed(u16 crc);
 void CYRF_StartReceive();
 void CYRF_ConfigSOPCode(const u8 *sopcodes);
 void CYRF_ConfigDataCode(const u8 *datacodes, u8 len);
+void CYRF_ConfigHop(const struct cyrf_hop *hop);
 u8 CYRF_ReadRSSI(u32 dodummyread);
 void CYRF_ReadDataPacketLen(u8 dpbuffer[], u8 length);
 void CYRF_WriteDataPacket(const u8 dpbuffer[]);
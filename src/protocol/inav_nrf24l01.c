@@ -616,8 +616,10 @@ static void update_telemetry(void)
     NRF24L01_WriteReg(NRF24L01_05_RF_CH, rf_channels[rf_channel_index]); // reset packet loss counter
 
     lost_packet_counter += lostPacketCount;
-    Telemetry.value[TELEM_LTM_STATUS_RSSI] = 100 - 100 * lost_packet_counter / packet_counter;
-    TELEMETRY_SetUpdated(TELEM_LTM_STATUS_RSSI);
+    if (packet_counter) {
+        Telemetry.value[TELEM_LTM_STATUS_RSSI] = 100 - 100 * lost_packet_counter / packet_counter;
+        TELEMETRY_SetUpdated(TELEM_LTM_STATUS_RSSI);
+    }
 
     // ackPayload contains telemetry in LTM format.
     // See https://github.com/stronnag/mwptools/blob/master/docs/ltm-definition.txt
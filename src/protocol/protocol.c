@@ -129,56 +129,202 @@ void PROTOCOL_DeInit()
     proto_state = PROTO_DEINIT;
 }
 
+#if defined(ENABLE_MODULAR) || defined(TEST)
+static const u8 *lz4_length(const u8 *src, const u8 *end, unsigned *len)
+{
+    if (*len != 15)
+        return src;
+    u8 b;
+    do {
+        if (src >= end)
+            return NULL;
+        b = *src++;
+        *len += b;
+    } while (b == 255);
+    return src;
+}
+
+/* LZ4 block decoder.  The source may overlap the end of the destination
+ * as long as the encoder checked that output never overtakes input */
+static int lz4_decompress(const u8 *src, int srclen, u8 *dst, int dstlen)
+{
+    const u8 *end = src + srclen;
+    u8 *dst_start = dst;
+    u8 *dst_end = dst + dstlen;
+    while (src < end) {
+        unsigned token = *src++;
+        unsigned len = token >> 4;
+        src = lz4_length(src, end, &len);
+        if (! src || len > (unsigned)(end - src) || len > (unsigned)(dst_end - dst))
+            return -1;
+        while (len--)
+            *dst++ = *src++;
+        if (src == end)
+            break;
+        if (end - src < 2)
+            return -1;
+        unsigned offset = src[0] | (src[1] << 8);
+        src += 2;
+        len = token & 0x0f;
+        src = lz4_length(src, end, &len);
+        len += 4;
+        if (! src || offset == 0 || offset > (unsigned)(dst - dst_start)
+            || len > (unsigned)(dst_end - dst))
+            return -1;
+        const u8 *match = dst - offset;
+        while (len--)
+            *dst++ = *match++;
+    }
+    return dst - dst_start;
+}
+#endif
+
+#ifdef ENABLE_MODULAR
 /*This symbol is exported bythe linker*/
 extern unsigned _data_loadaddr;
+
+/* Protocol modules are normally read from protocol/modules.pak (built by
+ * utils/pack_modules.py): an index keyed by protocol name followed by the
+ * LZ4 compressed modules.  Modules are decompressed in place: the packed
+ * data is read to the end of the module RAM region and expanded towards
+ * its start.  The release zip only ships the archive.  A protocol/<name>.mod
+ * per protocol is still loaded when there is no archive, or the protocol
+ * is missing from it, as on the internal filesystem of the 16K RAM radios.
+ * Only the module in RAM is reused, there is no cache of recently loaded
+ * modules: the modular radios have no RAM left besides the module region,
+ * and the radios with spare RAM link all protocols into the firmware.
+ */
+#define MODULE_MAX_SIZE  (4 * 1024)
+#define MODULE_NAME_LEN  16
+#define MODULE_PACK_FILE "protocol/modules.pak"
+
+struct module_entry {
+    char name[MODULE_NAME_LEN];
+    u32 offset;
+    u16 size;
+    u16 packed;   // == size if the module is stored uncompressed
+};
+
+static u32 loaded_offset;  // archive offset of the module in RAM (0 = unknown)
+
+/* The module in RAM is reused for another protocol.  Its first word was
+ * replaced by the protocol id, restore it for the load address check */
+static int reuse_module()
+{
+    *loaded_protocol = (unsigned long)&_data_loadaddr;
+    return 1;
+}
+
+static int unpack_module(const u8 *src, const struct module_entry *entry)
+{
+    u8 *region = (u8 *)loaded_protocol;
+    if (entry->packed == entry->size) {
+        memmove(region, src, entry->size);
+        return 1;
+    }
+    return lz4_decompress(src, entry->packed, region, entry->size) == entry->size;
+}
+
+static int find_module(FILE *fh, struct module_entry *entry)
+{
+    u8 hdr[8];
+    if (fread(hdr, 1, sizeof(hdr), fh) != sizeof(hdr) || memcmp(hdr, "DMOD", 4) != 0 || hdr[4] != 1)
+        return 0;
+    unsigned count = hdr[6] | (hdr[7] << 8);
+    for (unsigned i = 0; i < count; i++) {
+        if (fread(entry, 1, sizeof(*entry), fh) != sizeof(*entry))
+            return 0;
+        if (strncmp(entry->name, Protocols[Model.protocol].name, MODULE_NAME_LEN) == 0)
+            return entry->size <= MODULE_MAX_SIZE && entry->packed <= entry->size;
+    }
+    return 0;
+}
+
+/* Returns 1 if the module was loaded, 0 if there is no archive or the
+ * protocol isn't in it, -1 on a read error */
+static int pack_load(FATFS *fat)
+{
+    struct module_entry entry;
+    FILE *fh = fopen2(fat, MODULE_PACK_FILE, "r");
+    if (! fh)
+        return 0;
+    setbuf(fh, 0);
+    int res = find_module(fh, &entry);
+    if (res && entry.offset == loaded_offset) {
+        // Protocols sharing a module (DSM2/DSMX...) share the offset and don't need a reload
+        res = reuse_module();
+    } else if (res) {
+        u8 *src = (u8 *)loaded_protocol + MODULE_MAX_SIZE - entry.packed;
+        loaded_offset = 0;
+        res = -1;
+        if (fseek(fh, entry.offset, SEEK_SET) == 0
+            && fread(src, 1, entry.packed, fh) == entry.packed) {
+            if (unpack_module(src, &entry)) {
+                loaded_offset = entry.offset;
+                res = 1;
+            }
+        }
+    }
+    fclose(fh);
+    return res;
+}
+
+static int mod_load(FATFS *fat, char *file)
+{
+    strcpy(file, "protocol/");
+    strcat(file, Protocols[Model.protocol].name);
+    file[17] = '\0'; //truncate filename to 8 characters
+    strcat(file, ".mod");
+
+    FILE *fh = fopen2(fat, file, "r");
+    //printf("Loading %s: %08lx\n", file, fh);
+    if(! fh)
+        return 0;
+    loaded_offset = 0;
+    setbuf(fh, 0);
+    fread(loaded_protocol, 1, MODULE_MAX_SIZE, fh);
+    fclose(fh);
+    return 1;
+}
+#endif
+
 void PROTOCOL_Load(int no_dlg)
 {
     (void)no_dlg;
 #ifdef ENABLE_MODULAR
     FATFS ModuleFAT;
-    FILE *fh;
+    char file[25];
 
-    if(! PROTOCOL_HasModule(Model.protocol)) {
+    if(! PROTOCOL_HasModule(Model.protocol) || Model.protocol > PROTOCOL_COUNT) {
         *loaded_protocol = 0;
         return;
     }
     if(*loaded_protocol == Model.protocol)
         return;
-    char file[25];
-    strcpy(file, "protocol/");
-
-    if (Model.protocol > PROTOCOL_COUNT)
-    {
-        *loaded_protocol = 0;
-        return;
-    }
-    else
-    {
-        strcat(file, Protocols[Model.protocol].name);
-    }
-    file[17] = '\0'; //truncate filename to 8 characters
-    strcat(file, ".mod");
 
     memset(&ModuleFAT, 0, sizeof(ModuleFAT));
     finit(&ModuleFAT, "protocol");
-    fh = fopen2(&ModuleFAT, file, "r");
-    //printf("Loading %s: %08lx\n", file, fh);
-    if(! fh) {
+    int res = pack_load(&ModuleFAT);
+    if (! res)
+        res = mod_load(&ModuleFAT, file);
+    if (res <= 0) {
+        *loaded_protocol = 0;
         if(! no_dlg) {
-            sprintf(tempstring, "Misisng protocol:\n%s", file);
+            if (res)
+                sprintf(tempstring, "Corrupt protocol:\n%s", MODULE_PACK_FILE);
+            else
+                sprintf(tempstring, "Misisng protocol:\n%s", file);
             PAGE_ShowWarning(NULL, tempstring);
         }
         return;
     }
-    setbuf(fh, 0);
-    fread(loaded_protocol, 1, 4 * 1024, fh);
-    fclose(fh);
     if ((unsigned long)&_data_loadaddr != *loaded_protocol) {
         if(! no_dlg) {
             sprintf(tempstring, "Protocol Mismatch:\n%08x\n%08x", (unsigned long)&_data_loadaddr, *loaded_protocol);
             PAGE_ShowWarning(NULL, tempstring);
         }
         *loaded_protocol = 0;
+        loaded_offset = 0;
         return;
     }
     //printf("Updated %d (%d) bytes: Data: %08lx %08lx %08lx\n", size, len, *loaded_protocol, *(loaded_protocol+1), *(loaded_protocol+2));
@@ -195,6 +341,9 @@ void PROTOCOL_Load(int no_dlg)
     PROTOCOL_SetSwitch(get_module(Model.protocol));
     if (PROTOCOL_GetTelemetryState() != PROTO_TELEM_UNSUPPORTED) {
         memset(&Telemetry, 0, sizeof(Telemetry));
+#if HAS_DATALOG
+        TELEMETRY_ResetHistory();
+#endif
         TELEMETRY_SetType(PROTOCOL_GetTelemetryType());
     }
 
@@ -615,3 +764,6 @@ void PROTO_CS_LO(int module)
     }
 #endif
 }
+
+#define TESTNAME protocol
+#include <tests.h>
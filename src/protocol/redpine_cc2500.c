@@ -52,7 +52,7 @@ ctassert(LAST_PROTO_OPT <= NUM_PROTO_OPTS, too_many_protocol_opts);
 #define NUM_HOPS 50
 
 // Statics are not initialized on 7e so in initialize() if necessary
-static u8 calData[NUM_HOPS][3];
+static u8 hop_regs[NUM_HOPS][CC2500_HOP_LEN];
 static u8 channr;
 static u8 ctr;
 static s8 fine;
@@ -84,11 +84,7 @@ static void initialize_data()
 
 static void set_start(u8 ch)
 {
-    CC2500_Strobe(CC2500_SIDLE);
-    CC2500_WriteReg(CC2500_23_FSCAL3, calData[ch][0]);
-    CC2500_WriteReg(CC2500_24_FSCAL2, calData[ch][1]);
-    CC2500_WriteReg(CC2500_25_FSCAL1, calData[ch][2]);
-    CC2500_WriteReg(CC2500_0A_CHANNR, hop_data[ch]);
+    CC2500_ConfigHop(hop_regs[ch]);
 }
 
 #define RXNUM 16
@@ -361,9 +357,8 @@ static void redpine_init(unsigned int format) {
       CC2500_WriteReg(CC2500_0A_CHANNR, hop_data[c]);
       CC2500_Strobe(CC2500_SCAL);
       usleep(900);
-      calData[c][0] = CC2500_ReadReg(CC2500_23_FSCAL3);
-      calData[c][1] = CC2500_ReadReg(CC2500_24_FSCAL2);
-      calData[c][2] = CC2500_ReadReg(CC2500_25_FSCAL1);
+      CC2500_ReadRegisterMulti(CC2500_23_FSCAL3, &hop_regs[c][CC2500_HOP_FSCAL3], 3);
+      hop_regs[c][CC2500_HOP_CHANNR] = hop_data[c];
   }
 }
 
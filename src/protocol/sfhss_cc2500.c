@@ -106,7 +106,7 @@ static const u8 init_values[] = {
 
 // Fast calibration table, see page 55 of swrs040c.pdf
 // 31.2 Frequency Hopping and Multi-Channel Systems
-static u8 rf_cal[30][3];
+static u8 hop_regs[30][CC2500_HOP_LEN];
 
 static void tune_chan()
 {
@@ -117,9 +117,7 @@ static void tune_chan()
 
 static void tune_chan_fast()
 {
-    CC2500_Strobe(CC2500_SIDLE);
-    CC2500_WriteReg(CC2500_0A_CHANNR, rf_chan*6+16);
-    CC2500_WriteRegisterMulti(CC2500_23_FSCAL3, rf_cal[rf_chan], 3);
+    CC2500_ConfigHop(hop_regs[rf_chan]);
     usleep(6);
 }
 
@@ -262,7 +260,8 @@ static u16 SFHSS_cb()
         state = SFHSS_CAL;
         return 2000;
     case SFHSS_CAL:
-        CC2500_ReadRegisterMulti(CC2500_23_FSCAL3, rf_cal[rf_chan], 3);
+        CC2500_ReadRegisterMulti(CC2500_23_FSCAL3, &hop_regs[rf_chan][CC2500_HOP_FSCAL3], 3);
+        hop_regs[rf_chan][CC2500_HOP_CHANNR] = rf_chan*6+16;
         if (++rf_chan < 30) {
             tune_chan();
         } else {
@@ -49,12 +49,10 @@ u8 A7105_ReadReg(u8 address)
 
 void A7105_WriteData(u8 *dpbuffer, u8 len, u8 channel)
 {
-    int i;
     CS_LO();
     PROTOSPI_xfer(A7105_RST_WRPTR);
     PROTOSPI_xfer(0x05);
-    for (i = 0; i < len; i++)
-        PROTOSPI_xfer(dpbuffer[i]);
+    PROTOSPI_write(dpbuffer, len);
     CS_HI();
 
     A7105_WriteReg(0x0F, channel);
@@ -75,10 +75,31 @@ void CC2500_WriteRegisterMulti(u8 address, const u8 data[], u8 length)
 {
     CS_LO();
     PROTOSPI_xfer(CC2500_WRITE_BURST | address);
-    for(int i = 0; i < length; i++)
-    {
-        PROTOSPI_xfer(data[i]);
+    PROTOSPI_write(data, length);
+    CS_HI();
+}
+
+/* Apply a register script built with CC2500_SCRIPT_RUN() entries.
+ * Each run covers consecutive registers and is sent as one burst. */
+void CC2500_WriteRegisterScript(const u8 *script)
+{
+    while (script[1]) {
+        CC2500_WriteRegisterMulti(script[0], &script[2], script[1]);
+        script += 2 + script[1];
     }
+}
+
+/* Go to IDLE and load channel and calibration of the next hop in a single
+ * SPI transaction.  Strobes and single register writes may be followed by
+ * another header while CSn stays low, so only the final burst ends it. */
+void CC2500_ConfigHop(const u8 *hop)
+{
+    CS_LO();
+    PROTOSPI_xfer(CC2500_SIDLE);
+    PROTOSPI_xfer(CC2500_0A_CHANNR);
+    PROTOSPI_xfer(hop[CC2500_HOP_CHANNR]);
+    PROTOSPI_xfer(CC2500_WRITE_BURST | CC2500_23_FSCAL3);
+    PROTOSPI_write(&hop[CC2500_HOP_FSCAL3], 3);
     CS_HI();
 }
 
@@ -60,10 +60,7 @@ static void WriteRegisterMulti(u8 address, const u8 data[], u8 length)
 {
     CS_LO();
     PROTOSPI_xfer(0x80 | address);
-    for(u32 i = 0; i < length; i++)
-    {
-        PROTOSPI_xfer(data[i]);
-    }
+    PROTOSPI_write(data, length);
     CS_HI();
 }
 
@@ -254,6 +251,20 @@ void CYRF_ConfigDataCode(const u8 *datacodes, u8 len)
     WriteRegisterMulti(CYRF_23_DATA_CODE, datacodes, len);
 }
 
+/* Channel, CRC seed, SOP and data codes in 4 SPI transactions.  The CRC
+ * seed registers are adjacent and written with address auto-increment */
+void CYRF_ConfigHop(const struct cyrf_hop *hop)
+{
+    CYRF_WriteRegister(CYRF_00_CHANNEL, hop->channel);
+    CS_LO();
+    PROTOSPI_xfer(0x80 | 0x40 | CYRF_15_CRC_SEED_LSB);
+    PROTOSPI_xfer(hop->crc_seed & 0xff);
+    PROTOSPI_xfer(hop->crc_seed >> 8);
+    CS_HI();
+    WriteRegisterMulti(CYRF_22_SOP_CODE, hop->sop_code, 8);
+    WriteRegisterMulti(CYRF_23_DATA_CODE, hop->data_code, 16);
+}
+
 void CYRF_WritePreamble(u32 preamble)
 {
     CS_LO();
@@ -67,10 +67,7 @@ u8 NRF24L01_WriteRegisterMulti(u8 reg, const u8 data[], u8 length)
 {
     CS_LO();
     u8 res = PROTOSPI_xfer(W_REGISTER | ( REGISTER_MASK & reg));
-    for (u8 i = 0; i < length; i++)
-    {
-        PROTOSPI_xfer(data[i]);
-    }
+    PROTOSPI_write(data, length);
     CS_HI();
     return res;
 }
@@ -79,10 +76,7 @@ u8 NRF24L01_WritePayload(u8 *data, u8 length)
 {
     CS_LO();
     u8 res = PROTOSPI_xfer(W_TX_PAYLOAD);
-    for (u8 i = 0; i < length; i++)
-    {
-        PROTOSPI_xfer(data[i]);
-    }
+    PROTOSPI_write(data, length);
     CS_HI();
     return res;
 }
@@ -578,7 +572,7 @@ static u16 hs6200_calc_crc(u8* msg, u8 len)
     }
     // last byte (1 bit only)
     if(len > 0) {
-        crc = crc16_update(crc, msg[pos+1], 1);
+        crc = crc16_update(crc, msg[pos], 1);
     }
     
     return crc;
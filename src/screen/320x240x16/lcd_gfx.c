@@ -17,6 +17,7 @@ All text above must be included in any redistribution
 #include "common.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include "gui/gui.h"
 
 /* helper functions */
@@ -383,6 +384,12 @@ static int image_read_header(FILE *fh, u16 *w, u16 *h, u32 *black, u32 *white)
     return 1;
 }
 
+u8 LCD_CacheImage(const char *file)
+{
+    (void)file;
+    return 0;
+}
+
 u8 LCD_ImageDimensions(const char *file, u16 *w, u16 *h)
 {
     FILE *fh;
@@ -494,6 +501,194 @@ u8 LCD_ImageDimensions(const char *file, u16 *w, u16 *h)
     return 1;
 }
 
+#ifndef LCD_IMAGE_CACHE_SIZE
+    #define LCD_IMAGE_CACHE_SIZE 0
+#endif
+
+#if LCD_IMAGE_CACHE_SIZE
+/* One image kept decoded in RAM so that windowed redraws of it (the
+ * background behind every partial update) need no filesystem access.
+ * Pixels are stored as palette indices, one packbits stream per row:
+ * a control byte n < 0x80 is followed by n+1 literal indices, a control
+ * byte 0x80 | n by one index repeated n+1 times. */
+static struct {
+    char file[24];
+    u8 failed;
+    u16 w, h;
+    u16 num_colors;
+    u16 palette[256];
+    u16 row[LCD_HEIGHT];
+    u8 data[LCD_IMAGE_CACHE_SIZE];
+} image_cache;
+
+static int cache_color_index(u16 color)
+{
+    for (int i = 0; i < image_cache.num_colors; i++) {
+        if (image_cache.palette[i] == color)
+            return i;
+    }
+    if (image_cache.num_colors == 256)
+        return -1;
+    image_cache.palette[image_cache.num_colors] = color;
+    return image_cache.num_colors++;
+}
+
+// Append one row of pixels, returns the new end of the data or -1 if it doesn't fit
+static int cache_encode_row(const u16 *pixels, unsigned w, unsigned pos)
+{
+    unsigned i = 0;
+    while (i < w) {
+        unsigned run = 1;
+        while (i + run < w && run < 128 && pixels[i + run] == pixels[i])
+            run++;
+        if (run >= 3) {
+            int idx = cache_color_index(pixels[i]);
+            if (idx < 0 || pos + 2 > sizeof(image_cache.data))
+                return -1;
+            image_cache.data[pos++] = 0x80 | (run - 1);
+            image_cache.data[pos++] = idx;
+            i += run;
+            continue;
+        }
+        // Literal block up to the next run of 3 identical pixels
+        unsigned len = 0;
+        while (i + len < w && len < 128) {
+            if (i + len + 2 < w && pixels[i + len] == pixels[i + len + 1]
+                                && pixels[i + len] == pixels[i + len + 2])
+                break;
+            len++;
+        }
+        if (pos + 1 + len > sizeof(image_cache.data))
+            return -1;
+        image_cache.data[pos++] = len - 1;
+        for (unsigned j = 0; j < len; j++) {
+            int idx = cache_color_index(pixels[i + j]);
+            if (idx < 0)
+                return -1;
+            image_cache.data[pos++] = idx;
+        }
+        i += len;
+    }
+    return pos;
+}
+
+static int cache_draw(u16 x, u16 y, const char *file, s16 w, s16 h, u16 x_off, u16 y_off)
+{
+    if (! image_cache.w || strcmp(file, image_cache.file) != 0)
+        return 0;
+    if (w < 0)
+        w = image_cache.w;
+    if (h < 0)
+        h = image_cache.h;
+    if ((u16)w + x_off > image_cache.w || (u16)h + y_off > image_cache.h)
+        return 0;  // let the file path report it
+    LCD_DrawStart(x, y, x + w - 1, y + h - 1, DRAW_NWSE);
+    for (int j = 0; j < h; j++) {
+        const u8 *ptr = &image_cache.data[image_cache.row[y_off + j]];
+        unsigned skip = x_off;
+        int left = w;
+        while (left > 0) {
+            u8 ctl = *ptr++;
+            unsigned len = (ctl & 0x7f) + 1;
+            if (skip >= len) {
+                skip -= len;
+                ptr += (ctl & 0x80) ? 1 : len;
+                continue;
+            }
+            if (ctl & 0x80) {
+                u16 c = image_cache.palette[*ptr++];
+                for (len -= skip; len && left; len--, left--)
+                    LCD_DrawPixel(c);
+            } else {
+                ptr += skip;
+                for (len -= skip; len && left; len--, left--)
+                    LCD_DrawPixel(image_cache.palette[*ptr++]);
+                ptr += len;
+            }
+            skip = 0;
+        }
+    }
+    LCD_DrawStop();
+    return 1;
+}
+#endif  // LCD_IMAGE_CACHE_SIZE
+
+/* Decode a bitmap into the image cache so that LCD_DrawWindowedImageFromFile()
+ * serves it from RAM.  Returns 0 if the image cannot be cached, in which
+ * case it keeps being drawn from the file. */
+u8 LCD_CacheImage(const char *file)
+{
+#if LCD_IMAGE_CACHE_SIZE
+    if (strlen(file) >= sizeof(image_cache.file))
+        return 0;
+    if (strcmp(file, image_cache.file) == 0)
+        return ! image_cache.failed;
+    image_cache.w = 0;
+    image_cache.num_colors = 0;
+    image_cache.failed = 1;
+    strlcpy(image_cache.file, file, sizeof(image_cache.file));
+
+    FILE *fh = fopen(file, "rb");
+    if (! fh)
+        return 0;
+    setbuf(fh, 0);
+    u16 buf[480];
+    u8 *hdr = (u8 *)buf;
+    if (fread(hdr, 0x46, 1, fh) != 1 || hdr[0] != 'B' || hdr[1] != 'M'
+        || *((u16 *)(hdr + 0x1c)) != 16)
+    {
+        fclose(fh);
+        return 0;
+    }
+    u32 compression = *((u32 *)(hdr + 0x1e));
+    // Transparent (1555) images are composited, leave them to the file path
+    if (compression != 0 && (compression != 3
+                             || *((u16 *)(hdr + 0x36)) != 0xf800
+                             || *((u16 *)(hdr + 0x3a)) != 0x07e0
+                             || *((u16 *)(hdr + 0x3e)) != 0x001f))
+    {
+        fclose(fh);
+        return 0;
+    }
+    u32 offset = *((u32 *)(hdr + 0x0a));
+    u32 img_w = *((u32 *)(hdr + 0x12));
+    u32 img_h = *((u32 *)(hdr + 0x16));
+    if (img_w > sizeof(buf) / sizeof(buf[0]) || img_h > LCD_HEIGHT) {
+        fclose(fh);
+        return 0;
+    }
+    fseek(fh, offset, SEEK_SET);
+    // Rows are stored bottom-up and padded to 4 bytes
+    unsigned stride = (img_w * 2 + 3) & ~3;
+    int pos = 0;
+    for (int j = img_h - 1; j >= 0; j--) {
+        if (fread(buf, stride, 1, fh) != 1) {
+            fclose(fh);
+            return 0;
+        }
+        if (LCD_DEPTH == 1) {
+            for (unsigned i = 0; i < img_w; i++)
+                buf[i] = (buf[i] & 0x8410) == 0x8410 ?  0 : 0xffff;
+        }
+        image_cache.row[j] = pos;
+        pos = cache_encode_row(buf, img_w, pos);
+        if (pos < 0) {
+            printf("DEBUG: LCD_CacheImage: %s does not fit in the image cache\n", file);
+            fclose(fh);
+            return 0;
+        }
+    }
+    fclose(fh);
+    image_cache.w = img_w;
+    image_cache.h = img_h;
+    image_cache.failed = 0;
+    return 1;
+#else
+    (void)file;
+    return 0;
+#endif
+}
+
 void LCD_DrawWindowedImageFromFile(u16 x, u16 y, const char *file, s16 w, s16 h, u16 x_off, u16 y_off)
 {
     int i, j;
@@ -506,6 +701,10 @@ void LCD_DrawWindowedImageFromFile(u16 x, u16 y, const char *file, s16 w, s16 h,
 
     if (w == 0 || h == 0)
         return;
+#if LCD_IMAGE_CACHE_SIZE
+    if (cache_draw(x, y, file, w, h, x_off, y_off))
+        return;
+#endif
 
     fh = fopen(file, "rb");
     if(! fh) {
@@ -658,3 +857,6 @@ void LCD_DrawUSBLogo(int lcd_width, int lcd_height)
     LCD_DrawStop();
 }
 #endif
+
+#define TESTNAME lcd_gfx
+#include <tests.h>
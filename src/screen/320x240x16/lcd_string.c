@@ -56,37 +56,51 @@ static struct {
     unsigned int x;
     unsigned int y;
     u16          color;
-} cur_str;
-
+    u32          bg_color;
+} cur_str = {.bg_color = FONT_TRANSPARENT};
 
+/*
+ * The glyph is sent row by row through a single address window.  Unset
+ * pixels are filled with the background color when one is set, or with
+ * the display's transparent color if it has one.  Otherwise only the set
+ * pixels are written, opening a one row window at each horizontal span
+ * (LCD_DrawPixelXY() is not enough, some drivers leave a 1x1 window).
+ */
 void LCD_PrintCharXY(unsigned int x, unsigned int y, u32 c)
 {
     u8 row, col, width;
     u8 font[CHAR_BUF_SIZE];
-    const u8 *offset;
-    offset = font;
     char_read(font, c, &width);
-    if (! offset || ! width) {
+    if (! width) {
         printf("Could not locate character U-%04x\n", (int)c);
         return;
     }
-    // Check if the requested character is available
-    LCD_DrawStart(x, y, x + width - 1,  y + get_height() - 1, DRAW_NWSE);
-    for (col = 0; col < width; col++)
+    u8 height = get_height();
+    u8 row_bytes = ((height - 1) / 8) + 1;
+    u32 bg_color = cur_str.bg_color;
+#ifdef TRANSPARENT_COLOR
+    if (bg_color == FONT_TRANSPARENT)
+        bg_color = TRANSPARENT_COLOR;
+#endif
+    LCD_DrawStart(x, y, x + width - 1,  y + height - 1, DRAW_NWSE);
+    for (row = 0; row < height; row++)
     {
-        const u8 *data = offset++;
-        u8 bit = 0;
-        // Data is right aligned,adrawn top to bottom
-        for (row = 0; row < get_height(); ++row)
+        // Data is stored column by column, top to bottom
+        const u8 *data = font + row / 8;
+        u8 mask = 1 << (row % 8);
+        u8 in_span = 0;
+        for (col = 0; col < width; col++, data += row_bytes)
         {
-            if (bit == 8) {
-                data = offset++;
-                bit = 0;
+            if (*data & mask) {
+                if (bg_color == FONT_TRANSPARENT && ! in_span)
+                    LCD_DrawStart(x + col, y + row, x + width - 1, y + row, DRAW_NWSE);
+                LCD_DrawPixel(cur_str.color);
+                in_span = 1;
+            } else {
+                if (bg_color != FONT_TRANSPARENT)
+                    LCD_DrawPixel(bg_color);
+                in_span = 0;
             }
-            if (*data & (1 << bit)) {
-                LCD_DrawPixelXY(x + col, y + row, cur_str.color);
-            }
-            bit++;
         }
     }
     LCD_DrawStop();
@@ -197,5 +211,9 @@ void LCD_SetFontColor(u16 color) {
     cur_str.color = color;
 }
 
+void LCD_SetFontBackground(u32 color) {
+    cur_str.bg_color = color;
+}
+
 #define TESTNAME drawtext
 #include "tests.h"
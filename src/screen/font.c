@@ -20,13 +20,53 @@ static FSHANDLE FontFH;
 
 #define RANGE_TABLE_SIZE 20
 
+/* Widths of the printable ASCII characters are remembered per font so
+ * measuring a string doesn't seek through the font file for every
+ * character.  Pages switch fonts constantly, so keep a few of them. */
+#define WIDTH_CACHE_FIRST 0x20
+#define WIDTH_CACHE_LAST  0x7e
+#define WIDTH_UNKNOWN     0xff
+#if LCD_DEPTH == 1
+    #define WIDTH_CACHE_FONTS 1
+#else
+    #define WIDTH_CACHE_FONTS 4
+#endif
+
+static struct width_cache {
+    char name[9];
+    u8 width[WIDTH_CACHE_LAST - WIDTH_CACHE_FIRST + 1];
+} width_cache[WIDTH_CACHE_FONTS];
+static u8 width_cache_next;
+
 static struct font_def
 {
     FILE *fh;
     u8 height;          /* Character height for storage        */
     u16 range[2 * (RANGE_TABLE_SIZE + 1)];  /* Array containing the ranges of supported characters */
+    u8 *width;          /* Cached ASCII widths of the current font */
 }font;
 
+static u8 *get_width_cache(const char *fontname)
+{
+    struct width_cache *wc;
+    for (int i = 0; i < WIDTH_CACHE_FONTS; i++) {
+        if (strcmp(width_cache[i].name, fontname) == 0)
+            return width_cache[i].width;
+    }
+    wc = &width_cache[width_cache_next];
+    width_cache_next = (width_cache_next + 1) % WIDTH_CACHE_FONTS;
+    strlcpy(wc->name, fontname, sizeof(wc->name));
+    memset(wc->width, WIDTH_UNKNOWN, sizeof(wc->width));
+    return wc->width;
+}
+
+static u8 *cached_width(u32 c)
+{
+    if (c < WIDTH_CACHE_FIRST || c > WIDTH_CACHE_LAST || ! font.width)
+        return NULL;
+    return &font.width[c - WIDTH_CACHE_FIRST];
+}
+
 static u8 get_char_range(u32 c, u32 *begin, u32 *end)
 {
     u32 offset = 0;
@@ -73,9 +113,15 @@ u8 get_width(u32 c)
     u32 begin;
     u32 end;
 
+    u8 *cached = cached_width(c);
+    if (cached && *cached != WIDTH_UNKNOWN)
+        return *cached;
     u8 row_bytes = ((font.height - 1) / 8) + 1;
     get_char_range(c, &begin, &end);
-    return (end - begin) / row_bytes;
+    u8 width = (end - begin) / row_bytes;
+    if (cached)
+        *cached = width;
+    return width;
 }
 
 u8 get_height()
@@ -89,6 +135,7 @@ void close_font()
         fclose(font.fh);
         font.fh = NULL;
     }
+    font.width = NULL;
 }
 
 u8 open_font(const char* fontname)
@@ -127,5 +174,6 @@ u8 open_font(const char* fontname)
         if (start_c == 0 && end_c == 0)
             break;
     }
+    font.width = get_width_cache(fontname);
     return 1;
 }
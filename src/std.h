@@ -34,6 +34,7 @@
     size_t devo_fread(void *ptr, size_t size, size_t nmemb, FILE *stream);
     size_t devo_fwrite(void *ptr, size_t size, size_t nmemb, FILE *stream);
     void devo_setbuf(FILE *stream, char *buf);
+    int devo_setvbuf(FILE *stream, char *buf, int mode, size_t size);
     long devo_ftell(FILE *stream);
     void devo_finit(FSHANDLE *fh, const char *str);
     void fempty(FILE *fh);
@@ -56,6 +57,7 @@
     #define ftell devo_ftell
     #define finit devo_finit
     #define setbuf devo_setbuf
+    #define setvbuf devo_setvbuf
 #endif //USE_OWN_STDIO
 
 #if USE_OWN_PRINTF
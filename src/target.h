@@ -108,8 +108,13 @@ int SPITouch_IRQ();
 void SPITouch_Calibrate(s32 xscale, s32 yscale, s32 xoff, s32 yoff);
 
 /* Buttons and switches */
+#ifndef HAS_BUTTON_SCAN_ISR
+    #define HAS_BUTTON_SCAN_ISR 0   // 1 if the buttons are scanned from the SysTick
+#endif
 void Initialize_ButtonMatrix();
 u32 ScanButtons();
+void ButtonMatrix_Tick(u32 msecs);
+void ButtonMatrix_Poll();
 
 /* Rotary */
 void ROTARY_Init();
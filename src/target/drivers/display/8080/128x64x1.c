@@ -35,6 +35,12 @@ inline static void LCD_Data(unsigned data)
 {
     LCD_DATA = data;
 }
+
+inline static void LCD_DataBurst(const u8 *data, int len)
+{
+    while (len--)
+        LCD_DATA = *data++;
+}
 #define LCD_CONTRAST_FUNC(contrast) (0x20 + contrast * 0xC / 10)
 
 static void lcd_init_ports()
@@ -15,9 +15,11 @@
 #include <libopencm3/stm32/gpio.h>
 #include <libopencm3/stm32/rcc.h>
 #include <libopencm3/stm32/spi.h>
+#include <libopencm3/stm32/dma.h>
 #include "common.h"
 #include "gui/gui.h"
 #include "target/drivers/mcu/stm32/rcc.h"
+#include "target/drivers/mcu/stm32/dma.h"
 
 #define CS_HI() GPIO_pin_set(LCD_SPI.csn)
 #define CS_LO() GPIO_pin_clear(LCD_SPI.csn)
@@ -42,6 +44,48 @@ static void LCD_Data(unsigned cmd) {
     CS_HI();
 }
 
+/* Send a run of display data with a single chip-select.  Bytes are fed
+ * without waiting for each to be echoed back; the trailing DR/SR read
+ * clears the overrun so the next spi_xfer() starts clean. */
+static void LCD_DataBurst(const u8 *data, int len)
+{
+    DATA_MODE();
+    CS_LO();
+#ifdef LCD_SPI_TX_DMA
+    DMA_stream_reset(LCD_SPI_TX_DMA);
+    dma_set_peripheral_address(LCD_SPI_TX_DMA.dma, LCD_SPI_TX_DMA.stream, (u32) &SPI_DR(LCD_SPI.spi));
+    dma_set_memory_address(LCD_SPI_TX_DMA.dma, LCD_SPI_TX_DMA.stream, (u32) data);
+    dma_set_number_of_data(LCD_SPI_TX_DMA.dma, LCD_SPI_TX_DMA.stream, len);
+    dma_set_read_from_memory(LCD_SPI_TX_DMA.dma, LCD_SPI_TX_DMA.stream);
+    dma_enable_memory_increment_mode(LCD_SPI_TX_DMA.dma, LCD_SPI_TX_DMA.stream);
+    dma_set_peripheral_size(LCD_SPI_TX_DMA.dma, LCD_SPI_TX_DMA.stream, DMA_SxCR_PSIZE_8BIT);
+    dma_set_memory_size(LCD_SPI_TX_DMA.dma, LCD_SPI_TX_DMA.stream, DMA_SxCR_MSIZE_8BIT);
+    dma_set_priority(LCD_SPI_TX_DMA.dma, LCD_SPI_TX_DMA.stream, DMA_CCR_PL_LOW);
+    DMA_channel_select(LCD_SPI_TX_DMA);
+    DMA_enable_stream(LCD_SPI_TX_DMA);
+    spi_enable_tx_dma(LCD_SPI.spi);
+    while (!dma_get_interrupt_flag(LCD_SPI_TX_DMA.dma, LCD_SPI_TX_DMA.stream, DMA_TCIF))
+        ;
+    spi_disable_tx_dma(LCD_SPI.spi);
+    DMA_disable_stream(LCD_SPI_TX_DMA);
+    dma_clear_interrupt_flags(LCD_SPI_TX_DMA.dma, LCD_SPI_TX_DMA.stream, DMA_TCIF);
+#else
+    for (int i = 0; i < len; i++) {
+        while (!(SPI_SR(LCD_SPI.spi) & SPI_SR_TXE))
+            ;
+        SPI_DR(LCD_SPI.spi) = data[i];
+    }
+#endif
+    while (!(SPI_SR(LCD_SPI.spi) & SPI_SR_TXE))
+        ;
+    while (SPI_SR(LCD_SPI.spi) & SPI_SR_BSY)
+        ;
+    volatile u32 x = SPI_DR(LCD_SPI.spi);
+    x = SPI_SR(LCD_SPI.spi);
+    (void)x;
+    CS_HI();
+}
+
 static void lcd_init_ports()
 {
     // Initialization is mostly done in SPI Flash
@@ -50,6 +94,9 @@ static void lcd_init_ports()
     rcc_periph_clock_enable(get_rcc_from_pin(LCD_SPI_MODE));
     GPIO_setup_output(LCD_SPI.csn, OTYPE_PUSHPULL);
     GPIO_setup_output(LCD_SPI_MODE, OTYPE_PUSHPULL);
+#ifdef LCD_SPI_TX_DMA
+    rcc_periph_clock_enable(get_rcc_from_port(LCD_SPI_TX_DMA.dma));
+#endif
     if (HAS_OLED_DISPLAY)
         spi_set_baudrate_prescaler(LCD_SPI.spi, OLED_SPI_RATE);
 }
@@ -31,6 +31,10 @@ static u8 dirty[PHY_LCD_WIDTH];
 static u16 xstart, xend;  // After introducing logical view for devo10, the coordinate can be >= 5000
 static u16 xpos, ypos;
 static s8 dir;
+static u8 flush_deferred;
+
+// Clean columns between two dirty runs are resent if that is cheaper than a new address command
+#define LCD_RUN_GAP 3
 
 void lcd_display(uint8_t on)
 {
@@ -121,28 +125,54 @@ void LCD_DrawStart(unsigned int x0, unsigned int y0, unsigned int x1, unsigned i
  *   ...       ....     ...
  * (128, 31)   ....   (0, 31)
  */
-void LCD_DrawStop(void)
+static void lcd_flush()
 {
-    int col = 0;
-    int p, c;
-    for (p = 0; p < LCD_PAGES; p++) {
+    for (int p = 0; p < LCD_PAGES; p++) {
+        u8 mask = 1 << p;
         int init = 0;
-        for (c = 0; c < PHY_LCD_WIDTH; c++) {
-            if(dirty[c] & (1 << p)) {
-                if(! init) {
-                    lcd_set_page_address(p);
-                    lcd_set_column_address(c);
-                } else if(col+1 != c) {
-                    lcd_set_column_address(c);
-                }
-                LCD_Data(img[p * PHY_LCD_WIDTH + c]);
-                col = c;
+        int c = 0;
+        while (c < PHY_LCD_WIDTH) {
+            if (! (dirty[c] & mask)) {
+                c++;
+                continue;
+            }
+            // Extend the run over short clean gaps
+            int start = c;
+            int end = ++c;
+            while (c < PHY_LCD_WIDTH && c - end < LCD_RUN_GAP) {
+                if (dirty[c++] & mask)
+                    end = c;
             }
+            c = end;
+            if (! init) {
+                lcd_set_page_address(p);
+                init = 1;
+            }
+            lcd_set_column_address(start);
+            LCD_DataBurst(&img[p * PHY_LCD_WIDTH + start], end - start);
         }
     }
     memset(dirty, 0, sizeof(dirty));
 }
 
+/* Until the GUI has flushed once, every draw call is sent straight away so
+ * the boot and USB screens work without it.  After that the GUI calls
+ * LCD_ForceUpdate() once per refresh and the flush is batched there. */
+void LCD_DrawStop(void)
+{
+    if (! flush_deferred)
+        lcd_flush();
+}
+
+#ifndef LCD_ForceUpdate
+#error "Targets using this driver must '#define LCD_ForceUpdate LCD_ForceUpdate'"
+#endif
+void LCD_ForceUpdate()
+{
+    flush_deferred = 1;
+    lcd_flush();
+}
+
 /*
  * 2.
 Display Start Line Set
@@ -3,9 +3,8 @@
 
     #include "devofs/devofs.h"
 
-    typedef union {
+    typedef struct {
         FATFS fat;
-        FATFS fil;
     } DRIVE;
     #define FSHANDLE FATFS
 
@@ -25,11 +24,12 @@
     #define fs_filesize(x)                    (((x)->file_header.size1 << 8) | (x)->file_header.size2)
     #define fs_ltell(x)                       ((x)->file_cur_pos)
     #define fs_is_initialized(x)              (((FATFS *)(x))->start_sector != ((FATFS *)(x))->compact_sector)
+    #define fs_add_file_descriptor(x, y)      df_add_file_descriptor((FATFS *)(x))
     static inline void fs_init(FSHANDLE * fh, const char *drive)
     {
         (void)drive;
         if (!fs_is_initialized(fh))
-            df_add_file_descriptor((FATFS *)fh);
+            fs_add_file_descriptor(fh, drive);
     }
 
 #endif //_ENABLE_DEVOFS_H_
@@ -5,7 +5,6 @@
 
     typedef struct {
         FATFS fat;
-        FIL fil;
     } DRIVE;
     #define FSHANDLE FIL
 
@@ -16,7 +15,7 @@
         return res;
     }
     #define fs_is_initialized(x)            (((char *)(x))[0] != 0)
-    #define fs_add_file_descriptor(x, y)    FS_Mount(x, y)
+    #define fs_add_file_descriptor(x, y)    if (0) {}
     #define fs_open(fp, path, flags, mode)   f_open((fp), (path), (mode) == O_RDONLY ? FA_READ : FA_WRITE | ((flags) & O_CREAT ? FA_CREATE_ALWAYS : 0))
     #define fs_read                   f_read
     #define fs_lseek                  f_lseek
@@ -3,9 +3,8 @@
 
     #include "petit_fat/petit_fat.h"
 
-    typedef union {
+    typedef struct {
         FATFS fat;
-        FATFS fil;
     } DRIVE;
     #define FSHANDLE FATFS
 
@@ -36,9 +35,11 @@
     #define fs_close(x)               (x)->flag = 0
     #define fs_filesize(x)            (x)->fsize
     int FS_Mount(void *FAT, const char *drive);
+    void FS_AddFileDescriptor(void *FAT, const char *drive);
+    #define fs_add_file_descriptor(x, y)  FS_AddFileDescriptor(x, y)
     static inline void fs_init(FSHANDLE * fh, const char *drive)
     {
         if (!fs_is_initialized(fh))
-            FS_Mount(fh, drive);
+            fs_add_file_descriptor(fh, drive);
     }
 #endif //_ENABLE_PETIT_FAT_H_
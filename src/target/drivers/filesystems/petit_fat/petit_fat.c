@@ -346,6 +346,50 @@ int mem_cmp (const void* dst, const void* src, int cnt) {
 
 
 
+/*-----------------------------------------------------------------------*/
+/* FAT access - Read a few bytes of the FAT through the cache            */
+/*-----------------------------------------------------------------------*/
+#if _FAT_CACHE
+
+static BYTE fat_cache[_FAT_CACHE];
+static DWORD fat_cache_sect;	/* Sector of the cached bytes (0:Empty, the FAT never starts at sector 0) */
+static WORD fat_cache_ofs;		/* Offset of the cached bytes in the sector */
+static BYTE fat_cache_drive;
+
+static
+DRESULT fat_readp (
+	BYTE* dest,		/* Pointer to the destination object */
+	DWORD sect,		/* FAT sector# (lba) */
+	WORD ofs,		/* Offset in the sector */
+	WORD cnt		/* Byte count, the bytes must not cross the sector end */
+)
+{
+	FATFS *fs = FatFs;
+	WORD start;
+
+
+	if (sect != fat_cache_sect || fs->pad1 != fat_cache_drive
+		|| ofs < fat_cache_ofs || ofs + cnt > fat_cache_ofs + _FAT_CACHE) {
+		start = ofs - ofs % _FAT_CACHE;				/* Aligned window, or one starting at the entry if it straddles */
+		if (ofs + cnt > start + _FAT_CACHE) start = ofs;
+		if (start > SECTOR_SIZE - _FAT_CACHE) start = SECTOR_SIZE - _FAT_CACHE;
+		fat_cache_sect = 0;
+		if (disk_readp(fat_cache, sect, start, _FAT_CACHE)) return RES_ERROR;
+		fat_cache_sect = sect;
+		fat_cache_ofs = start;
+		fat_cache_drive = fs->pad1;
+	}
+	ofs -= fat_cache_ofs;
+	while (cnt--) *dest++ = fat_cache[ofs++];
+	return RES_OK;
+}
+#else
+#define fat_readp disk_readp
+#endif
+
+
+
+
 /*-----------------------------------------------------------------------*/
 /* FAT access - Read value of a FAT entry                                */
 /*-----------------------------------------------------------------------*/
@@ -369,20 +413,20 @@ CLUST get_fat (	/* 1:IO error, Else:Cluster status */
 		bc = (WORD)clst; bc += bc / 2;
 		ofs = bc % SECTOR_SIZE; bc /= SECTOR_SIZE;
 		if (ofs != (SECTOR_SIZE - 1)) {
-			if (disk_readp(buf, fs->fatbase + bc, ofs, 2)) break;
+			if (fat_readp(buf, fs->fatbase + bc, ofs, 2)) break;
 		} else {
-			if (disk_readp(buf, fs->fatbase + bc, (SECTOR_SIZE - 1), 1)) break;
-			if (disk_readp(buf+1, fs->fatbase + bc + 1, 0, 1)) break;
+			if (fat_readp(buf, fs->fatbase + bc, (SECTOR_SIZE - 1), 1)) break;
+			if (fat_readp(buf+1, fs->fatbase + bc + 1, 0, 1)) break;
 		}
 		wc = LD_WORD(buf);
 		return (clst & 1) ? (wc >> 4) : (wc & 0xFFF);
 #endif
 	case FS_FAT16 :
-		if (disk_readp(buf, fs->fatbase + clst / (SECTOR_SIZE / 2), (WORD)(((WORD)clst % (SECTOR_SIZE / 2)) * 2), 2)) break;
+		if (fat_readp(buf, fs->fatbase + clst / (SECTOR_SIZE / 2), (WORD)(((WORD)clst % (SECTOR_SIZE / 2)) * 2), 2)) break;
 		return LD_WORD(buf);
 #if _FS_FAT32
 	case FS_FAT32 :
-		if (disk_readp(buf, fs->fatbase + clst / (SECTOR_SIZE / 4), (WORD)(((WORD)clst % (SECTOR_SIZE / 4)) * 4), 4)) break;
+		if (fat_readp(buf, fs->fatbase + clst / (SECTOR_SIZE / 4), (WORD)(((WORD)clst % (SECTOR_SIZE / 4)) * 4), 4)) break;
 		return LD_DWORD(buf) & 0x0FFFFFFF;
 #endif
 	}
@@ -413,6 +457,83 @@ DWORD clust2sect (	/* !=0: Sector number, 0: Failed - invalid cluster# */
 
 
 
+/*-----------------------------------------------------------------------*/
+/* Cluster map - Find the cluster# of a file cluster without the FAT     */
+/*-----------------------------------------------------------------------*/
+#if _USE_FASTSEEK
+
+static
+void build_map (void)
+{
+	FATFS *fs = FatFs;
+	CLUST clst, idx, last;
+	BYTE n = 0;
+
+
+	last = (CLUST)((fs->fsize + (DWORD)fs->csize * SECTOR_SIZE - 1) / ((DWORD)fs->csize * SECTOR_SIZE));
+	clst = fs->org_clust;
+	for (idx = 0; idx < last; idx++) {
+		if (clst < 2 || clst >= fs->n_fatent) break;	/* Broken chain, map what was found */
+		if (!n || clst != fs->map[n - 1][1] + (idx - fs->map[n - 1][0])) {	/* Start of a new run? */
+			if (n == _FASTSEEK_RUNS) break;		/* Too fragmented, the rest is followed in the FAT */
+			fs->map[n][0] = idx;
+			fs->map[n][1] = clst;
+			n++;
+		}
+		if (idx + 1 < last) clst = get_fat(clst);
+	}
+	fs->map_len = idx;
+	fs->map_runs = n;
+	fs->flag |= FA__MAP;
+}
+
+static
+CLUST map_clust (	/* 0:Not in the map, Else:Cluster# */
+	CLUST idx		/* Cluster index in the file */
+)
+{
+	FATFS *fs = FatFs;
+	BYTE lo = 0, hi, mid;
+
+
+	if (!(fs->flag & FA__MAP) || idx >= fs->map_len) return 0;
+	hi = fs->map_runs - 1;
+	while (lo < hi) {					/* Find the last run starting at or before idx */
+		mid = (lo + hi + 1) / 2;
+		if (fs->map[mid][0] <= idx) lo = mid;
+		else hi = mid - 1;
+	}
+	return fs->map[lo][1] + (idx - fs->map[lo][0]);
+}
+#endif
+
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Get the cluster# at the file pointer (which is on a cluster boundary) */
+/*-----------------------------------------------------------------------*/
+
+static
+CLUST next_clust (	/* 0,1:Error, Else:Cluster# */
+	void
+)
+{
+	FATFS *fs = FatFs;
+	CLUST clst;
+
+
+	if (fs->fptr == 0) return fs->org_clust;	/* On the top of the file? */
+#if _USE_FASTSEEK
+	clst = map_clust((CLUST)(fs->fptr / ((DWORD)fs->csize * SECTOR_SIZE)));
+	if (clst) return clst;
+#endif
+	return get_fat(fs->curr_clust);
+}
+
+
+
+
 /*-----------------------------------------------------------------------*/
 /* Directory handling - Rewind directory index                           */
 /*-----------------------------------------------------------------------*/
@@ -747,6 +868,9 @@ FRESULT pf_mount (
 
 
 	FatFs = 0;
+#if _FAT_CACHE
+	fat_cache_sect = 0;
+#endif
 	if (!fs) return FR_OK;				/* Unregister fs object */
 
 	if (disk_initialize() & STA_NOINIT)	/* Check if the drive is ready or not */
@@ -834,6 +958,9 @@ FRESULT pf_open (
 		return FR_NOT_ENABLED;
 
 	fs->flag = 0;
+#if _FAT_CACHE
+	fat_cache_sect = 0;		/* The FAT may have been changed over USB since the last open */
+#endif
 	dj.fn = sp;
 	res = follow_path(&dj, dir, path);	/* Follow the file path */
 	if (res != FR_OK) return res;		/* Follow failed */
@@ -884,8 +1011,7 @@ FRESULT pf_read (
 		if ((fs->fptr % SECTOR_SIZE) == 0) {				/* On the sector boundary? */
 			cs = (BYTE)(fs->fptr / SECTOR_SIZE & (fs->csize - 1));	/* Sector offset in the cluster */
 			if (!cs) {								/* On the cluster boundary? */
-				clst = (fs->fptr == 0) ?			/* On the top of the file? */
-					fs->org_clust : get_fat(fs->curr_clust);
+				clst = next_clust();
 				if (clst <= 1) goto fr_abort;
 				fs->curr_clust = clst;				/* Update current cluster */
 			}
@@ -972,8 +1098,7 @@ FRESULT pf_write (
 		if (((WORD)fs->fptr % SECTOR_SIZE) == 0) {			/* On the sector boundary? */
 			cs = (BYTE)((fs->fptr / SECTOR_SIZE) & (fs->csize - 1));	/* Sector offset in the cluster */
 			if (!cs) {								/* On the cluster boundary? */
-				clst = (fs->fptr == 0) ?			/* On the top of the file? */
-					fs->org_clust : get_fat(fs->curr_clust);
+				clst = next_clust();
 				if (clst <= 1) goto fw_abort;
 				fs->curr_clust = clst;				/* Update current cluster */
 			}
@@ -1027,6 +1152,22 @@ FRESULT pf_lseek (
 	fs->fptr = 0;
 	if (ofs > 0) {
 		bcs = (DWORD)fs->csize * SECTOR_SIZE;	/* Cluster size (byte) */
+#if _USE_FASTSEEK
+		if ((ifptr == 0 || (ofs - 1) / bcs != (ifptr - 1) / bcs)
+			&& !(fs->flag & FA__MAP)) build_map();	/* Leaving the current cluster, map the chain once */
+		clst = map_clust((CLUST)((ofs - 1) / bcs));
+		if (clst) {							/* Jump straight to the cluster */
+			fs->curr_clust = clst;
+			fs->fptr = ofs;
+			ofs = 0;
+		} else if ((fs->flag & FA__MAP) && fs->map_len
+			&& (ifptr == 0 || (ifptr - 1) / bcs < (DWORD)fs->map_len - 1)) {	/* When seek past the map from inside it, */
+			fs->fptr = (DWORD)(fs->map_len - 1) * bcs;	/* start from the last mapped cluster */
+			ofs -= fs->fptr;
+			clst = map_clust(fs->map_len - 1);
+			fs->curr_clust = clst;
+		} else
+#endif
 		if (ifptr > 0 &&
 			(ofs - 1) / bcs >= (ifptr - 1) / bcs) {	/* When seek to same or following cluster, */
 			fs->fptr = (ifptr - 1) & ~(bcs - 1);	/* start from the current cluster */
@@ -1140,3 +1281,6 @@ FRESULT pf_readdir (
 
 #endif /* _USE_DIR */
 
+
+#define TESTNAME petit_fat
+#include <tests.h>
@@ -33,6 +33,11 @@
 
 #define	_USE_LSEEK	1	/* 1:Enable pf_lseek() */
 
+#define	_USE_FASTSEEK	1	/* 1:Map the cluster chain of an open file for pf_lseek() */
+#define	_FASTSEEK_RUNS	6	/* Number of contiguous cluster runs the map can hold */
+
+#define	_FAT_CACHE	64	/* Bytes of the FAT kept for cluster chain walks (0:Disable) */
+
 #define	_USE_WRITE	1	/* 1:Enable pf_write() */
 
 #define _FS_FAT12	1	/* 1:Enable FAT12 support */
@@ -90,6 +95,11 @@ typedef struct {
 	CLUST	curr_clust;	/* File current cluster */
 	DWORD	dsect;		/* File current data sector */
 	DWORD   dir_entry;	/* Pointer to the directory object for opened file */
+#if _USE_FASTSEEK
+	CLUST	map_len;	/* Number of file clusters covered by map[] */
+	BYTE	map_runs;	/* Number of valid entries in map[] */
+	CLUST	map[_FASTSEEK_RUNS][2];	/* Cluster runs {file cluster index, cluster#} */
+#endif
 } FATFS;
 
 
@@ -156,6 +166,7 @@ FRESULT pf_readdir (DIR*, FILINFO*);			/* Read a directory item from the open di
 #define	FA_OPENED	0x01
 #define	FA_WPRT		0x02
 #define	FA__WIP		0x40
+#define	FA__MAP		0x80
 
 
 /* FAT sub type (FATFS.fs_type) */
@@ -15,6 +15,7 @@
 
 #include "petit_io.h"
 #include "common.h"
+#include "target/drivers/storage/block_cache.h"
 
 /*-----------------------------------------------------------------------*/
 /* Initialize Disk Drive                                                 */
@@ -35,6 +36,37 @@ static const struct {
 u8 _drive_num = 0;
 u8 _stop_on_cr = 0;
 
+#define ADDRESS(sector, sofs) (((sector) + drive[_drive_num].SECTOR_OFFSET) * 0x1000 + (sofs))
+
+#if BLOCK_CACHE_BLOCKS
+/* The drive number is the cache's device number */
+static int read_blocks(u32 block, unsigned count, u8 *buf)
+{
+	drive[_drive_num].ReadBytes(block * BLOCK_CACHE_BLOCK_SIZE, count * BLOCK_CACHE_BLOCK_SIZE, buf);
+	return 0;
+}
+
+static void read_bytes(u32 addr, u32 count, u8 *dest)
+{
+	BLOCKCACHE_Read(_drive_num, read_blocks, addr / BLOCK_CACHE_BLOCK_SIZE, addr % BLOCK_CACHE_BLOCK_SIZE, count, dest);
+}
+
+static int read_bytes_stop_cr(u32 addr, u32 count, u8 *dest)
+{
+	return BLOCKCACHE_ReadStopCR(_drive_num, read_blocks, addr / BLOCK_CACHE_BLOCK_SIZE, addr % BLOCK_CACHE_BLOCK_SIZE, count, dest);
+}
+
+static void invalidate(u32 addr, u32 count)
+{
+	u32 first = addr / BLOCK_CACHE_BLOCK_SIZE;
+	BLOCKCACHE_Invalidate(_drive_num, first, (addr + count + BLOCK_CACHE_BLOCK_SIZE - 1) / BLOCK_CACHE_BLOCK_SIZE - first);
+}
+#else
+#define read_bytes(addr, count, dest)         drive[_drive_num].ReadBytes(addr, count, dest)
+#define read_bytes_stop_cr(addr, count, dest) drive[_drive_num].ReadBytesStopCR(addr, count, dest)
+#define invalidate(addr, count)               do {} while (0)
+#endif
+
 DSTATUS disk_initialize (void)
 {
 	DSTATUS stat = 0;
@@ -56,7 +88,7 @@ DRESULT disk_readp (
 )
 {
 	//printf("Reading sector: %d, offset: %d size: %d\n", (int)sector, (int)sofs, (int)count);
-	drive[_drive_num].ReadBytes((sector + drive[_drive_num].SECTOR_OFFSET) * 0x1000 + sofs, count, dest);
+	read_bytes(ADDRESS(sector, sofs), count, dest);
 	//int max = count > 64 ? 64 : count;
 	//for(int i = 0; i < max; i++) {
 	//    printf("%02x ", dest[i]);
@@ -75,10 +107,10 @@ DRESULT disk_readp_cnt (
 )
 {
 	if (_stop_on_cr) {
-                *actual = drive[_drive_num].ReadBytesStopCR((sector + drive[_drive_num].SECTOR_OFFSET) * 0x1000 + sofs, count, dest);
+                *actual = read_bytes_stop_cr(ADDRESS(sector, sofs), count, dest);
 	} else {
 		*actual = count;
-                drive[_drive_num].ReadBytes((sector + drive[_drive_num].SECTOR_OFFSET) * 0x1000 + sofs, count, dest);
+                read_bytes(ADDRESS(sector, sofs), count, dest);
 	}
 	return RES_OK;
 }
@@ -96,7 +128,8 @@ DRESULT disk_writep_rand (
 	WORD count			/* Byte count (bit15:destination) */
 )
 {
-	drive[_drive_num].WriteBytes((sector + drive[_drive_num].SECTOR_OFFSET) * 0x1000 + sofs, count, src);
+	invalidate(ADDRESS(sector, sofs), count);
+	drive[_drive_num].WriteBytes(ADDRESS(sector, sofs), count, src);
 	return RES_OK;
 }
 
@@ -104,7 +137,8 @@ DRESULT disk_erasep (
         DWORD sc
 )
 {
-	drive[_drive_num].EraseSector((sc + drive[_drive_num].SECTOR_OFFSET) * 0x1000);
+	invalidate(ADDRESS(sc, 0), 0x1000);
+	drive[_drive_num].EraseSector(ADDRESS(sc, 0));
         return RES_OK;
 }
 
@@ -118,7 +152,8 @@ DRESULT disk_writep (
 	if (!buff) {
 		if (sc) {
 			// Initiate write process
-			pos = (sc + drive[_drive_num].SECTOR_OFFSET) * 0x1000;
+			pos = ADDRESS(sc, 0);
+			invalidate(pos, 0x1000);
                         drive[_drive_num].EraseSector(pos);
 		} else {
 			// Finalize write process
@@ -126,6 +161,7 @@ DRESULT disk_writep (
 		}
 	} else {
 		// Send data to the disk
+		invalidate(pos, sc);
                 drive[_drive_num].WriteBytes(pos, sc, buff);
 		pos += sc;
 	}
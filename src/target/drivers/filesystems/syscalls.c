@@ -32,13 +32,20 @@ extern void printstr(char *, int);
 #define dbgprintf(args...) if (DEBUG_SYSCALLS) printf(args)
 #define dbgMsec()          ((DEBUG_SYSCALLS) ? CLOCK_getms() : 0)
 
+// Files opened without their own handle share this pool (per drive)
+#ifndef FS_OPEN_FILES
+    #define FS_OPEN_FILES 3
+#endif
+
 static DIR   dir;
 
 #ifdef MEDIA_DRIVE
-static DRIVE drive[2];
+#define NUM_DRIVES 2
 #else
-static DRIVE drive[1];
+#define NUM_DRIVES 1
 #endif
+static DRIVE drive[NUM_DRIVES];
+static FSHANDLE files[NUM_DRIVES][FS_OPEN_FILES];
 
 extern u8 _drive_num;
 
@@ -93,6 +100,44 @@ void FS_Unmount()
     fs_mount(0);
 }
 
+static int drive_index(const char *path)
+{
+    (void)path;
+#ifdef MEDIA_DRIVE
+    if (strncmp(path, "media", 5) == 0 && (path[5] == '/' || path[5] == '\0'))
+        return 1;
+#endif
+    return 0;
+}
+
+#ifdef _ENABLE_PETIT_FAT_H_
+/* A new handle takes its volume information from the mounted drive rather
+ * than mounting the drive again.  Every handle keeps its own file state, so
+ * switching between open files never needs to re-open or re-seek them
+ */
+void FS_AddFileDescriptor(void *_f, const char *drive_name)
+{
+    FATFS *f = (FATFS *)_f;
+    *f = drive[drive_index(drive_name)].fat;
+    f->flag = 0;
+}
+#endif
+
+static FSHANDLE *alloc_handle(const char *file)
+{
+    int num = drive_index(file);
+    for (int i = 0; i < FS_OPEN_FILES; i++) {
+        FSHANDLE *fh = &files[num][i];
+        if (! fs_is_initialized(fh)) {
+            fs_init(fh, num ? "media" : "");
+            return fh;
+        }
+        if (! fs_is_open(fh))
+            return fh;
+    }
+    return NULL;
+}
+
 int FS_OpenDir(const char *path)
 {
     FATFS *ptr = &drive[0].fat;
@@ -134,12 +179,11 @@ intptr_t _open_r(FSHANDLE *r, const char *file, int flags, int mode) {
     (void)mode;
 
     if(!r) {
-#ifdef MEDIA_DRIVE
-        if (strncmp(file, "media/", 6) == 0)
-            r = (FSHANDLE *)&drive[1].fil;
-        else
-#endif
-            r = (FSHANDLE *)&drive[0].fil;
+        r = alloc_handle(file);
+        if (!r) {
+            dbgprintf("_open_r: no free file handle for %s\n", file);
+            return -1;
+        }
     }
     if(fs_is_open(r)) {
         dbgprintf("_open_r(%08lx): file already open.\n", r);
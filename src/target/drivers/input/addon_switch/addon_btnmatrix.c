@@ -42,21 +42,31 @@ void _scan_extra_switches()
     }
 }
 
-uint32_t ADDON_Handle_ExtraSwitches(u32 result) {
-    uint32_t button_mask = 0;
-    #define BUTTONDEF(x) button_mask |= (1 << ((BUT_ ## x) - 1));
+static uint32_t button_mask()
+{
+    uint32_t mask = 0;
+    #define BUTTONDEF(x) mask |= (1 << ((BUT_ ## x) - 1));
     #include "capabilities.h"
     #undef BUTTONDEF
-    if (!(result & button_mask)) {
-        if ((SW_ENABLED(SWITCH_2x2) || SW_ENABLED(SWITCH_3x1)) && SW_ENABLED(SWITCH_STOCK)) {
-            _scan_extra_switches();
-        }
-        if (!SW_ENABLED(SWITCH_STOCK)) {
-            // The extra lines can only be used if the original switches were removed
-            global_extra_switches = result;
-        }
+    return mask;
+}
+
+// Only reads the matrix result, so this is safe to call from the SysTick
+uint32_t ADDON_Handle_ExtraSwitches(u32 result) {
+    uint32_t mask = button_mask();
+    if (!(result & mask) && !SW_ENABLED(SWITCH_STOCK)) {
+        // The extra lines can only be used if the original switches were removed
+        global_extra_switches = result;
+    }
+    return result & mask;
+}
+
+// Reconfigures EXTRA_SWITCH_COL_OD, so this must run in the main loop
+void ADDON_ScanExtraSwitches(u32 buttons) {
+    if (!(buttons & button_mask())
+        && (SW_ENABLED(SWITCH_2x2) || SW_ENABLED(SWITCH_3x1)) && SW_ENABLED(SWITCH_STOCK)) {
+        _scan_extra_switches();
     }
-    return result & button_mask;
 }
 
 #endif  // EXTRA_SWITCHES
@@ -31,6 +31,14 @@ unsigned ADC_Read(unsigned channel);
 volatile u16 adc_array_raw[NUM_ADC_CHANNELS];
 static volatile u16 adc_array_oversample[SAMPLE_COUNT];
 
+/* Calibrated and conditioned inputs, updated once per ADC_Filter() call.
+ * The calibration reciprocals are rebuilt when Transmitter.calibration changes
+ */
+static volatile s32 adc_array_norm[INP_HAS_CALIBRATION];
+static struct StickCalibration dsp_calibrated[INP_HAS_CALIBRATION];
+static struct dsp_calibration dsp_cal[INP_HAS_CALIBRATION];
+static struct dsp_state dsp_state[INP_HAS_CALIBRATION];
+
 #if 0
     // These are the valid ADC pins for an STM32
     ADC_CHAN(GPIOA, GPIO0),  /* ADC123_0  */ \
@@ -188,6 +196,20 @@ void ADC_Filter()
         result /= ADC_OVERSAMPLE_WINDOW_COUNT * WINDOW_SIZE;
         adc_array_raw[i] = result;
     }
+
+    #define ADC_CHAN(x, y, z) (z)
+    static const s8 chan_inverted[NUM_ADC_CHANNELS] = ADC_CHANNELS;
+    #undef ADC_CHAN
+    for (int i = 0; i < INP_HAS_CALIBRATION; i++) {
+        const struct StickCalibration *cal = &Transmitter.calibration[i];
+        if (memcmp(cal, &dsp_calibrated[i], sizeof(*cal)) != 0) {
+            dsp_calibrated[i] = *cal;
+            DSP_SetCalibration(&dsp_cal[i], cal->min, cal->max, cal->zero);
+        }
+        s32 value = DSP_Calibrate(&dsp_cal[i], ADC_ReadRawInput(i + 1));
+        value = DSP_Process(&InputDSP[i], &dsp_state[i], value);
+        adc_array_norm[i] = value * chan_inverted[i];
+    }
 }
 
 s32 ADC_ReadRawInput(int channel)
@@ -199,33 +221,7 @@ s32 ADC_ReadRawInput(int channel)
 
 s32 ADC_NormalizeChannel(int channel)
 {
-    s32 value = ADC_ReadRawInput(channel);
-    s32 max = Transmitter.calibration[channel - 1].max;
-    s32 min = Transmitter.calibration[channel - 1].min;
-    s32 zero = Transmitter.calibration[channel - 1].zero;
-    if (!zero) {
-        // If this input doesn't have a zero, calculate from max/min
-        zero = ((u32)max + min) / 2;
-    }
-    // Derate min and max by 1% to ensure we can get all the way to 100%
-    max = (max - zero) * 99 / 100;
-    min = (min - zero) * 99 / 100;
-    if (value >= zero) {
-        value = (value - zero) * CHAN_MAX_VALUE / max;
-    } else {
-        value = (value - zero) * CHAN_MIN_VALUE / min;
-    }
-    // Bound output
-    if (value > CHAN_MAX_VALUE)
-        value = CHAN_MAX_VALUE;
-    if (value < CHAN_MIN_VALUE)
-        value = CHAN_MIN_VALUE;
-
-    #define ADC_CHAN(x, y, z) (z)
-    const s8 chan_inverted[NUM_ADC_CHANNELS] = ADC_CHANNELS;
-    #undef ADC_CHAN
-    value = value * chan_inverted[channel - 1];
-    return value;
+    return adc_array_norm[channel - 1];
 }
 
 void ADC_ScanChannels()
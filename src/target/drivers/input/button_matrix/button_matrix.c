@@ -14,6 +14,7 @@
 */
 #include "common.h"
 #include "config/tx.h"
+#include "buttons.h"
 #include "target/drivers/mcu/stm32/rcc.h"
 
 enum {
@@ -31,7 +32,18 @@ enum {
 
 static const u8 buttonmap[] = BUTTON_MATRIX;
 
+/* With HAS_BUTTON_SCAN_ISR the matrix is only driven from the SysTick, and
+ * ScanButtons() returns the latest sample so that the main loop never
+ * changes the row pins in the middle of a scan.  The extra switch probe
+ * rewrites the port configuration, which main loop code also does, so it
+ * runs from ButtonMatrix_Poll() instead, with the SysTick scan paused.
+ */
+static volatile u8 scan_isr;
+static volatile u32 last_scan;
+static u32 scan_matrix();
+
 extern uint32_t ADDON_Handle_ExtraSwitches(u32 result);
+extern void ADDON_ScanExtraSwitches(u32 buttons);
 void Initialize_ButtonMatrix()
 {
     /* Enable AFIO */
@@ -45,9 +57,43 @@ void Initialize_ButtonMatrix()
 #endif
     GPIO_pin_set(BUTTON_MATRIX_ROW_OD);
     GPIO_setup_input(BUTTON_MATRIX_COL_PU, ITYPE_PULLUP);
+
+    scan_isr = 0;
+    last_scan = scan_matrix();
+    scan_isr = HAS_BUTTON_SCAN_ISR;
 }
 
 u32 ScanButtons()
+{
+    if (scan_isr)
+        return last_scan;
+    u32 result = scan_matrix();
+#if defined(EXTRA_SWITCHES)
+    ADDON_ScanExtraSwitches(result);
+#endif
+    return result;
+}
+
+void ButtonMatrix_Poll()
+{
+#if defined(EXTRA_SWITCHES)
+    if (! scan_isr)
+        return;
+    scan_isr = 0;
+    ADDON_ScanExtraSwitches(last_scan);
+    scan_isr = HAS_BUTTON_SCAN_ISR;
+#endif
+}
+
+void ButtonMatrix_Tick(u32 msecs)
+{
+    if (! scan_isr || msecs % BUTTON_SCAN_MSEC)
+        return;
+    last_scan = scan_matrix();
+    BUTTON_Sample(last_scan, msecs);
+}
+
+static u32 scan_matrix()
 {
     unsigned idx = 0;
     u32 result = 0;
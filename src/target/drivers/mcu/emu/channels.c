@@ -15,6 +15,8 @@
 #include "common.h"
 #include "target/drivers/mcu/emu/fltk.h"
 #include "mixer.h"
+#include "config/tx.h"
+#include "rf_model.h"
 
 #define KEY_INP_SWA gui.rud_dr
 #define KEY_INP_SWB gui.ele_dr
@@ -54,9 +56,31 @@ s32 ADC_ReadRawInput(int channel)
     return 0;
 }
 
+/* The GUI inputs are already in the channel range, so there is nothing to
+ * calibrate, but they go through the tx.ini input conditioning once per
+ * mixer frame as they do on the transmitter
+ */
+static s32 adc_array_norm[INP_HAS_CALIBRATION];
+static struct dsp_state dsp_state[INP_HAS_CALIBRATION];
+
+void ADC_Filter()
+{
+    for (int i = 0; i < INP_HAS_CALIBRATION; i++)
+        adc_array_norm[i] = DSP_Process(&InputDSP[i], &dsp_state[i], ADC_ReadRawInput(i + 1));
+}
+
 s32 ADC_NormalizeChannel(int channel)
 {
-    return ADC_ReadRawInput(channel);
+    static s32 last_value[11];
+    s32 value = ADC_ReadRawInput(channel);
+    // Lets the RF model measure stick-to-receiver latency
+    if (channel < (int)(sizeof(last_value) / sizeof(s32)) && value != last_value[channel]) {
+        last_value[channel] = value;
+        RFMODEL_InputChanged();
+    }
+    if (channel > 0 && channel <= INP_HAS_CALIBRATION)
+        return adc_array_norm[channel - 1];
+    return value;
 }
 
 s32 SWITCH_ReadRawInput(int channel)
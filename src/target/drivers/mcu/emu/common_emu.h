@@ -9,4 +9,6 @@
     TIMER_ENABLE
 //This is a trick to only enable this function in the emu and to use an inline version for devo
 #define LCD_ForceUpdate LCD_ForceUpdate
+// Plenty of RAM to keep the background decoded
+#define LCD_IMAGE_CACHE_SIZE 65536
 #endif
@@ -68,5 +68,6 @@ struct Gui {
 
 extern struct Gui gui;
 void set_stick_positions();
+void ADC_Filter();
 
 #endif
@@ -3,10 +3,17 @@
 
 u8 PROTOSPI_read3wire();
 u8 PROTOSPI_xfer(u8 byte);
-#define PROTOSPI_pin_set(io) if (0) {}
-#define PROTOSPI_pin_clear(io) if (0) {}
+void PROTOSPI_write(const u8 *data, int len);
+#include "rf_model.h"
+#define PROTOSPI_pin_set(io) RFMODEL_SetPin(&(io), 1)
+#define PROTOSPI_pin_clear(io) RFMODEL_SetPin(&(io), 0)
 #define _NOP() if(0) {}
 
+#undef CYRF_RESET_PIN
+#undef AVR_RESET_PIN
+#define CYRF_RESET_PIN ((struct mcu_pin){0, 0})
+#define AVR_RESET_PIN ((struct mcu_pin){0, 0})
+
 #pragma weak A7105_Reset
 #pragma weak CC2500_Reset
 #pragma weak CYRF_Reset
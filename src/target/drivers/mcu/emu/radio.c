@@ -17,6 +17,7 @@
 #include "protocol/interface.h"
 #include "config/model.h"
 #include "config/tx.h"
+#include "rf_model.h"
 
 #include <stdlib.h>
 
@@ -123,9 +124,15 @@ int SPI_ProtoGetPinConfig(int module, int state) {
     return 0;
 }
 
-u8 PROTOSPI_read3wire() { return 0x00; }
+u8 PROTOSPI_read3wire() { return RFMODEL_Xfer(0x00); }
 
-u8 PROTOSPI_xfer(u8 byte) { return byte; }
+u8 PROTOSPI_xfer(u8 byte) { return RFMODEL_Xfer(byte); }
+
+void PROTOSPI_write(const u8 *data, int len)
+{
+    for (int i = 0; i < len; i++)
+        RFMODEL_Xfer(data[i]);
+}
 
 #ifdef PROTO_HAS_A7105
 int A7105_Reset() { return 1; }
@@ -0,0 +1,765 @@
+/*
+ This project is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Deviation is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "mixer.h"
+#include "protocol/interface.h"
+#include "config/model.h"
+#include "config/tx.h"
+#include "rf_model.h"
+
+#include <stdlib.h>
+
+/* Only the behaviour the protocol drivers depend on is modelled:
+ * register file, FIFOs, TX/RX state and the status bits polled for
+ * completion.  Timing is instantaneous: a packet is 'on air' as soon
+ * as the TX strobe is issued.
+ */
+#define RF_FIFO_SIZE   64
+#define RF_NUM_CHIPS   4  // CYRF6936, A7105, CC2500, NRF24L01
+#define REPORT_MSEC    5000
+
+enum {
+    RF_IDLE,
+    RF_RX,
+};
+
+struct rf_chip {
+    u8 reg[64];
+    u8 id[4];              // A7105 ID register
+    u8 tx_fifo[RF_FIFO_SIZE];
+    u8 rx_fifo[RF_FIFO_SIZE];
+    u8 pending[RF_FIFO_SIZE];  // injected frame, delivered on next RX
+    u8 tx_len;
+    u8 rx_len;
+    u8 rx_pos;
+    u8 pending_len;
+    u8 state;
+    u8 listen;             // TX'd a packet since the last RX
+};
+
+/* Updates 'channels' from a data packet and returns the number of channels
+ * the protocol carries, or 0 if this isn't a data packet.  Protocols which
+ * spread the channels over several packets only update the ones they got. */
+struct rf_decoder {
+    u16 protocol;
+    int (*decode)(const u8 *pkt, int len, s32 *channels);
+};
+
+static struct rf_chip chip[RF_NUM_CHIPS];
+
+/* current SPI transaction */
+static s8 cs_module = -1;
+static u8 xfer_pos;
+static u8 xfer_cmd;
+static u8 xfer_addr;
+
+static struct {
+    u32 packets;
+    u32 lost;
+    u32 bytes;
+    u32 last_time;
+    u32 max_gap;
+    u32 start_time;
+    u32 report_time;
+    u32 hop_mask[8];       // RF channels seen since the last report
+    u32 input_time;        // when the sticks last moved, 0 if latency was measured
+    u32 latency_sum;
+    u32 latency_max;
+    u32 latency_count;
+    s32 decoded[NUM_OUT_CHANNELS];
+    u16 protocol;
+    u8 loss_pct;
+    u8 dump;
+    u8 telem[RF_FIFO_SIZE];
+    u8 telem_len;
+    u8 init;
+} rx;
+
+/*
+ * Loopback receiver
+ */
+static s32 us_to_chan(int us)
+{
+    return (us - 1500) * CHAN_MAX_VALUE / 500;
+}
+
+#ifdef PROTO_HAS_CYRF6936
+static int devo_decode(const u8 *pkt, int len, s32 *channels)
+{
+    // 0x0b-0x0e carry channels 1-4, 5-8, 9-12 and 13-16, the sign bits in pkt[9]
+    int type = pkt[0] & 0x0f;
+    if (len < 16 || type < 0x0b || type > 0x0e)
+        return 0;
+    int num = pkt[0] >> 4;
+    int first = (type - 0x0b) * 4;
+    for (int i = 0; i < 4 && first + i < NUM_OUT_CHANNELS; i++) {
+        s32 value = (pkt[2 * i + 1] | (pkt[2 * i + 2] << 8)) * CHAN_MAX_VALUE / 0x640;
+        channels[first + i] = (pkt[9] & (1 << (7 - i))) ? -value : value;
+    }
+    return num;
+}
+
+static int dsm_decode(const u8 *pkt, int len, s32 *channels)
+{
+    if (len < 16)
+        return 0;
+    // Bind packets repeat the ID in bytes 4-7
+    if (pkt[0] == pkt[4] && pkt[1] == pkt[5] && pkt[2] == pkt[6] && pkt[3] == pkt[7])
+        return 0;
+    int bits = Model.protocol == PROTOCOL_DSMX ? 11 : 10;
+    s32 max = 1 << bits;
+    s32 pct_100 = max * 100 / 150;
+    int num = 0;
+    for (int i = 0; i < 7; i++) {
+        u16 word = (pkt[2 * i + 2] << 8) | pkt[2 * i + 3];
+        if (word == 0xffff)
+            continue;
+        int ch = (word >> bits) & 0x0f;
+        if (ch >= NUM_OUT_CHANNELS)
+            continue;
+        channels[ch] = ((word & (max - 1)) - max / 2) * CHAN_MAX_VALUE / (pct_100 / 2);
+        if (ch >= num)
+            num = ch + 1;
+    }
+    return num;
+}
+#endif
+
+#ifdef PROTO_HAS_A7105
+static int flysky_decode(const u8 *pkt, int len, s32 *channels)
+{
+    if (len < 21 || pkt[0] != 0x55)
+        return 0;
+    for (int i = 0; i < 8; i++)
+        channels[i] = us_to_chan(pkt[5 + 2 * i] | (pkt[6 + 2 * i] << 8));
+    return 8;
+}
+#endif
+
+#ifdef PROTO_HAS_CC2500
+static int frsky_decode(const u8 *pkt, int len, s32 *channels)
+{
+    // Bind packets have the table offset in pkt[5], which is never 1
+    if (len < 18 || pkt[0] != 0x11 || pkt[5] != 0x01)
+        return 0;
+    // 12-bit values: low bytes in 6-9 and 12-15, high nibbles in 10-11 and 16-17
+    for (int i = 0; i < 8; i++) {
+        int lo = i < 4 ? 6 + i : 8 + i;
+        int hi = (i < 4 ? 10 : 16) + ((i & 3) >> 1);
+        s32 value = pkt[lo] | (((pkt[hi] >> (4 * (i & 1))) & 0x0f) << 8);
+        channels[i] = (value - 0x8ca) * CHAN_MAX_VALUE / 600;
+    }
+    return 8;
+}
+#endif
+
+static const struct rf_decoder decoders[] = {
+#ifdef PROTO_HAS_CYRF6936
+    {PROTOCOL_DEVO, devo_decode},
+    {PROTOCOL_DSM2, dsm_decode},
+    {PROTOCOL_DSMX, dsm_decode},
+#endif
+#ifdef PROTO_HAS_A7105
+    {PROTOCOL_FLYSKY, flysky_decode},
+#endif
+#ifdef PROTO_HAS_CC2500
+    {PROTOCOL_FRSKY2WAY, frsky_decode},
+#endif
+    {PROTOCOL_NONE, NULL},
+};
+
+static void rx_init()
+{
+    const char *env;
+    memset(&rx, 0, sizeof(rx));
+    rx.init = 1;
+    if ((env = getenv("RFMODEL_DUMP")))
+        rx.dump = atoi(env);
+    if ((env = getenv("RFMODEL_LOSS")))
+        rx.loss_pct = atoi(env);
+    if ((env = getenv("RFMODEL_TELEM"))) {
+        while (env[0] && env[1] && rx.telem_len < RF_FIFO_SIZE) {
+            char hex[3] = {env[0], env[1], 0};
+            rx.telem[rx.telem_len++] = strtol(hex, NULL, 16);
+            env += 2;
+        }
+    }
+}
+
+static void rx_reset_stats(u32 now)
+{
+    rx.packets = 0;
+    rx.lost = 0;
+    rx.bytes = 0;
+    rx.max_gap = 0;
+    rx.latency_sum = 0;
+    rx.latency_max = 0;
+    rx.latency_count = 0;
+    memset(rx.hop_mask, 0, sizeof(rx.hop_mask));
+    rx.start_time = now;
+    rx.report_time = now + REPORT_MSEC;
+}
+
+static void rx_report(u32 now)
+{
+    int hops = 0;
+    for (int i = 0; i < 256; i++)
+        if (rx.hop_mask[i / 32] & (1 << (i % 32)))
+            hops++;
+    u32 elapsed = now - rx.start_time;
+    printf("RF %s: %d pkts (%d/s) %d lost, %d bytes, %d channels, max gap %dms",
+           PROTOCOL_Name(), (int)rx.packets, elapsed ? (int)(rx.packets * 1000 / elapsed) : 0,
+           (int)rx.lost, (int)rx.bytes, hops, (int)rx.max_gap);
+    if (rx.latency_count)
+        printf(", latency avg %dms max %dms",
+               (int)(rx.latency_sum / rx.latency_count), (int)rx.latency_max);
+    printf("\n");
+    rx_reset_stats(now);
+}
+
+static void rx_decode(const u8 *data, int len, u32 now)
+{
+    s32 channels[NUM_OUT_CHANNELS];
+    for (const struct rf_decoder *dec = decoders; dec->decode; dec++) {
+        if (dec->protocol != Model.protocol)
+            continue;
+        memcpy(channels, rx.decoded, sizeof(channels));
+        int num = dec->decode(data, len, channels);
+        if (num > NUM_OUT_CHANNELS)
+            num = NUM_OUT_CHANNELS;
+        if (! num)
+            return;
+        if (memcmp(channels, rx.decoded, sizeof(channels)) == 0)
+            return;
+        memcpy(rx.decoded, channels, sizeof(channels));
+        if (rx.dump) {
+            printf("RX %s:", PROTOCOL_Name());
+            for (int i = 0; i < num; i++)
+                printf(" %d", (int)RANGE_TO_PCT(channels[i]));
+            printf("\n");
+        }
+        if (rx.input_time) {
+            u32 latency = now - rx.input_time;
+            rx.latency_sum += latency;
+            rx.latency_count++;
+            if (latency > rx.latency_max)
+                rx.latency_max = latency;
+            rx.input_time = 0;
+        }
+        return;
+    }
+}
+
+static void rx_packet(int module, u8 channel, const u8 *data, int len)
+{
+    u32 now = CLOCK_getms();
+    if (! rx.init)
+        rx_init();
+    if (rx.protocol != Model.protocol) {
+        rx.protocol = Model.protocol;
+        memset(rx.decoded, 0, sizeof(rx.decoded));
+        rx_reset_stats(now);
+    } else if ((s32)(now - rx.report_time) >= 0) {
+        rx_report(now);
+    }
+    if (rx.dump) {
+        printf("TX %s ch %02x:", MODULE_NAME[module], channel);
+        for (int i = 0; i < len; i++)
+            printf(" %02x", data[i]);
+        printf("\n");
+    }
+    chip[module].listen = 1;
+    rx.hop_mask[channel / 32] |= 1 << (channel % 32);
+    if (rx.loss_pct && rand() % 100 < rx.loss_pct) {
+        rx.lost++;
+        return;
+    }
+    if (rx.packets && now - rx.last_time > rx.max_gap)
+        rx.max_gap = now - rx.last_time;
+    rx.last_time = now;
+    rx.packets++;
+    rx.bytes += len;
+    rx_decode(data, len, now);
+}
+
+/* Returns the frame a receiver would answer with when the TX listens */
+static void rx_listen(int module)
+{
+    struct rf_chip *c = &chip[module];
+    if (c->pending_len || ! c->listen)
+        return;
+    c->listen = 0;
+    if (rx.telem_len) {
+        memcpy(c->pending, rx.telem, rx.telem_len);
+        c->pending_len = rx.telem_len;
+    }
+}
+
+static int rx_deliver(struct rf_chip *c)
+{
+    if (! c->pending_len)
+        return 0;
+    memcpy(c->rx_fifo, c->pending, c->pending_len);
+    c->rx_len = c->pending_len;
+    c->rx_pos = 0;
+    c->pending_len = 0;
+    return 1;
+}
+
+void RFMODEL_InjectRx(int module, const u8 *data, int len)
+{
+    if (module < 0 || module >= RF_NUM_CHIPS)
+        return;
+    if (len > RF_FIFO_SIZE)
+        len = RF_FIFO_SIZE;
+    memcpy(chip[module].pending, data, len);
+    chip[module].pending_len = len;
+}
+
+void RFMODEL_InputChanged()
+{
+    if (! rx.input_time)
+        rx.input_time = CLOCK_getms();
+}
+
+static void fifo_push(u8 *fifo, u8 *len, u8 byte)
+{
+    if (*len < RF_FIFO_SIZE)
+        fifo[(*len)++] = byte;
+}
+
+static u8 fifo_pop(struct rf_chip *c)
+{
+    return c->rx_pos < c->rx_len ? c->rx_fifo[c->rx_pos++] : 0;
+}
+
+/*
+ * CYRF6936
+ * Header: bit7 = write, bit6 = auto-increment, bits 5:0 = register
+ */
+#ifdef PROTO_HAS_CYRF6936
+static void cyrf_reset(struct rf_chip *c)
+{
+    memset(c, 0, sizeof(*c));
+    c->reg[CYRF_10_FRAMING_CFG] = 0xa5;
+}
+
+static void cyrf_write(struct rf_chip *c, u8 addr, u8 data)
+{
+    switch (addr) {
+    case CYRF_20_TX_BUFFER:
+        fifo_push(c->tx_fifo, &c->tx_len, data);
+        return;
+    case CYRF_02_TX_CTRL:
+        if (data & 0x40)
+            c->tx_len = 0;
+        if (data & 0x80) {
+            int len = c->reg[CYRF_01_TX_LENGTH];
+            if (len > c->tx_len)
+                len = c->tx_len;
+            c->reg[CYRF_04_TX_IRQ_STATUS] = 0x02;
+            rx_packet(CYRF6936, c->reg[CYRF_00_CHANNEL], c->tx_fifo, len);
+            c->tx_len = 0;
+        }
+        break;
+    case CYRF_05_RX_CTRL:
+        if (data & 0x80) {
+            rx_listen(CYRF6936);
+            c->reg[CYRF_07_RX_IRQ_STATUS] = 0;
+            if (rx_deliver(c)) {
+                c->reg[CYRF_07_RX_IRQ_STATUS] = 0x02;
+                c->reg[CYRF_09_RX_COUNT] = c->rx_len;
+                c->reg[CYRF_0A_RX_LENGTH] = c->rx_len;
+                c->reg[CYRF_08_RX_STATUS] = 0;
+            }
+        }
+        break;
+    case CYRF_1D_MODE_OVERRIDE:
+        if (data & 0x01) {
+            cyrf_reset(c);
+            return;
+        }
+        break;
+    }
+    c->reg[addr] = data;
+}
+
+static u8 cyrf_read(struct rf_chip *c, u8 addr)
+{
+    static const u8 mfg_id[6] = {0x4b, 0x70, 0x31, 0x10, 0xa3, 0x42};
+    switch (addr) {
+    case CYRF_21_RX_BUFFER:
+        return fifo_pop(c);
+    case CYRF_25_MFG_ID:
+        return mfg_id[xfer_pos % 6];
+    case CYRF_04_TX_IRQ_STATUS: {
+        u8 val = c->reg[addr];
+        c->reg[addr] &= ~0x03;
+        return val;
+    }
+    }
+    return c->reg[addr];
+}
+
+static u8 cyrf_xfer(struct rf_chip *c, u8 byte)
+{
+    if (xfer_pos == 0) {
+        xfer_cmd = byte;
+        xfer_addr = byte & 0x3f;
+        return 0;
+    }
+    u8 addr = xfer_addr;
+    if (xfer_cmd & 0x40)
+        xfer_addr = (xfer_addr + 1) & 0x3f;
+    if (xfer_cmd & 0x80) {
+        cyrf_write(c, addr, byte);
+        return 0;
+    }
+    return cyrf_read(c, addr);
+}
+#endif
+
+/*
+ * A7105
+ * Header: bit7 = strobe, bit6 = read, bits 5:0 = register
+ * Reads go through the 3-wire interface, which ends up here as well.
+ */
+#ifdef PROTO_HAS_A7105
+static void a7105_reset(struct rf_chip *c)
+{
+    memset(c, 0, sizeof(*c));
+    c->reg[0x10] = 0x9e;
+}
+
+static void a7105_strobe(struct rf_chip *c, u8 cmd)
+{
+    switch (cmd & 0xf0) {
+    case A7105_TX:
+        c->state = RF_IDLE;
+        rx_packet(A7105, c->reg[A7105_0F_PLL_I], c->tx_fifo, c->tx_len);
+        break;
+    case A7105_RX:
+        rx_listen(A7105);
+        c->state = rx_deliver(c) ? RF_IDLE : RF_RX;
+        break;
+    case A7105_RST_WRPTR:
+        c->tx_len = 0;
+        break;
+    case A7105_RST_RDPTR:
+        c->rx_pos = 0;
+        break;
+    default:
+        c->state = RF_IDLE;
+        break;
+    }
+}
+
+static u8 a7105_read(struct rf_chip *c, u8 addr)
+{
+    switch (addr) {
+    case A7105_00_MODE:
+        // TRER stays set while the receiver waits for a packet
+        return c->state == RF_RX ? 0x01 : 0x00;
+    case A7105_05_FIFO_DATA:
+        return fifo_pop(c);
+    case A7105_06_ID_DATA:
+        return c->id[(xfer_pos - 1) & 3];
+    case A7105_22_IF_CALIB_I:
+        return c->reg[addr] & ~A7105_MASK_FBCF;
+    case A7105_25_VCO_SBCAL_I:
+        return c->reg[addr] & ~A7105_MASK_VBCF;
+    }
+    return c->reg[addr];
+}
+
+static void a7105_write(struct rf_chip *c, u8 addr, u8 data)
+{
+    switch (addr) {
+    case A7105_00_MODE:
+        a7105_reset(c);
+        return;
+    case A7105_02_CALC:
+        // calibration finishes immediately
+        c->reg[addr] = 0;
+        return;
+    case A7105_05_FIFO_DATA:
+        fifo_push(c->tx_fifo, &c->tx_len, data);
+        return;
+    case A7105_06_ID_DATA:
+        c->id[(xfer_pos - 1) & 3] = data;
+        return;
+    }
+    c->reg[addr] = data;
+}
+
+static u8 a7105_xfer(struct rf_chip *c, u8 byte)
+{
+    if (xfer_pos == 0) {
+        if (byte & 0x80) {
+            a7105_strobe(c, byte);
+            // a strobe can be followed by another command in the same cycle
+            xfer_pos = (u8)-1;
+            return 0;
+        }
+        xfer_cmd = byte;
+        xfer_addr = byte & 0x3f;
+        return 0;
+    }
+    if (xfer_cmd & 0x40)
+        return a7105_read(c, xfer_addr);
+    a7105_write(c, xfer_addr, byte);
+    return 0;
+}
+#endif
+
+/*
+ * CC2500
+ * Header: bit7 = read, bit6 = burst, bits 5:0 = register
+ * 0x30-0x3D without burst are command strobes, with burst status registers
+ */
+#ifdef PROTO_HAS_CC2500
+#define CC2500_CMD_BURST 0x40
+static void cc2500_reset(struct rf_chip *c)
+{
+    memset(c, 0, sizeof(*c));
+}
+
+static void cc2500_strobe(struct rf_chip *c, u8 cmd)
+{
+    switch (cmd) {
+    case CC2500_SRES:
+        cc2500_reset(c);
+        break;
+    case CC2500_STX:
+        c->state = RF_IDLE;
+        rx_packet(CC2500, c->reg[CC2500_0A_CHANNR], c->tx_fifo, c->tx_len);
+        c->tx_len = 0;
+        break;
+    case CC2500_SRX:
+        rx_listen(CC2500);
+        c->state = RF_RX;
+        if (rx_deliver(c) && (c->reg[CC2500_07_PKTCTRL1] & 0x04)) {
+            // appended status: RSSI, CRC_OK | LQI
+            fifo_push(c->rx_fifo, &c->rx_len, 0x40);
+            fifo_push(c->rx_fifo, &c->rx_len, 0x80);
+        }
+        break;
+    case CC2500_SFRX:
+        c->rx_len = c->rx_pos = 0;
+        break;
+    case CC2500_SFTX:
+        c->tx_len = 0;
+        break;
+    case CC2500_SIDLE:
+    case CC2500_SPWD:
+        c->state = RF_IDLE;
+        break;
+    }
+}
+
+static u8 cc2500_status(struct rf_chip *c, u8 addr)
+{
+    switch (addr) {
+    case 0x30: return 0x80;  // PARTNUM
+    case 0x31: return 0x03;  // VERSION
+    case 0x34: return 0x40;  // RSSI
+    case 0x35: return c->state == RF_RX ? 0x0d : 0x01;  // MARCSTATE
+    case 0x3a: return c->tx_len;
+    case 0x3b: return c->rx_len - c->rx_pos;
+    }
+    return 0;
+}
+
+static u8 cc2500_xfer(struct rf_chip *c, u8 byte)
+{
+    u8 status = (c->state == RF_RX ? CC2500_STATE_RX : CC2500_STATE_IDLE);
+    if (xfer_pos == 0) {
+        xfer_cmd = byte;
+        xfer_addr = byte & 0x3f;
+        if (xfer_addr >= 0x30 && xfer_addr <= 0x3d && ! (byte & CC2500_CMD_BURST)) {
+            cc2500_strobe(c, xfer_addr);
+            // strobes and single accesses can be followed by another header
+            xfer_pos = (u8)-1;
+        }
+        return status;
+    }
+    u8 addr = xfer_addr;
+    if ((xfer_cmd & CC2500_CMD_BURST) && addr < 0x3e)
+        xfer_addr++;
+    else
+        xfer_pos = (u8)-1;
+    if (xfer_cmd & CC2500_READ_SINGLE) {
+        if (addr == 0x3f)
+            return fifo_pop(c);
+        if (addr >= 0x30 && addr <= 0x3d)
+            return cc2500_status(c, addr);
+        return c->reg[addr];
+    }
+    if (addr == 0x3f)
+        fifo_push(c->tx_fifo, &c->tx_len, byte);
+    else if (addr < 0x30)
+        c->reg[addr] = byte;
+    return status;
+}
+#endif
+
+/*
+ * NRF24L01
+ * One command byte followed by data, the STATUS register is clocked out
+ * with the command.  CE is assumed to be tied high.
+ */
+#ifdef PROTO_HAS_NRF24L01
+#define NRF_R_REGISTER  0x00
+#define NRF_W_REGISTER  0x20
+#define NRF_R_RX_PAYLOAD 0x61
+#define NRF_W_TX_PAYLOAD 0xA0
+
+static u8 nrf_status(struct rf_chip *c)
+{
+    // RX_P_NO = 111 when the RX FIFO is empty
+    return (c->reg[NRF24L01_07_STATUS] & 0x70) | (c->rx_len ? 0x00 : 0x0e);
+}
+
+static void nrf_config(struct rf_chip *c)
+{
+    u8 config = c->reg[NRF24L01_00_CONFIG];
+    if ((config & 0x03) != 0x03)
+        return;
+    rx_listen(NRF24L01);
+    if (! c->rx_len && rx_deliver(c))
+        c->reg[NRF24L01_07_STATUS] |= 0x40;  // RX_DR
+}
+
+static u8 nrf_read(struct rf_chip *c, u8 addr)
+{
+    switch (addr) {
+    case NRF24L01_07_STATUS:
+        return nrf_status(c);
+    case NRF24L01_17_FIFO_STATUS:
+        return (c->tx_len ? 0x00 : 0x10) | (c->rx_len ? 0x00 : 0x01);
+    }
+    // address registers only keep their first byte
+    return xfer_pos == 1 ? c->reg[addr] : 0;
+}
+
+static void nrf_write(struct rf_chip *c, u8 addr, u8 data)
+{
+    if (xfer_pos > 1)
+        return;
+    if (addr == NRF24L01_07_STATUS) {
+        c->reg[addr] &= ~(data & 0x70);
+        return;
+    }
+    c->reg[addr] = data;
+    if (addr == NRF24L01_00_CONFIG)
+        nrf_config(c);
+}
+
+static u8 nrf_xfer(struct rf_chip *c, u8 byte)
+{
+    if (xfer_pos == 0) {
+        xfer_cmd = byte;
+        u8 status = nrf_status(c);
+        switch (byte) {
+        case NRF24L01_E1_FLUSH_TX:
+            c->tx_len = 0;
+            break;
+        case NRF24L01_E2_FLUSH_RX:
+            c->rx_len = c->rx_pos = 0;
+            break;
+        case NRF_W_TX_PAYLOAD:
+        case NRF24L01_B0_TX_PYLD_NOACK:
+            c->tx_len = 0;
+            break;
+        case NRF_R_RX_PAYLOAD:
+            c->rx_pos = 0;
+            break;
+        }
+        return status;
+    }
+    if (xfer_cmd == NRF_W_TX_PAYLOAD || xfer_cmd == NRF24L01_B0_TX_PYLD_NOACK) {
+        fifo_push(c->tx_fifo, &c->tx_len, byte);
+        return 0;
+    }
+    if (xfer_cmd == NRF_R_RX_PAYLOAD)
+        return fifo_pop(c);
+    if (xfer_cmd == NRF24L01_60_R_RX_PL_WID)
+        return c->rx_len;
+    if ((xfer_cmd & 0xe0) == NRF_R_REGISTER)
+        return nrf_read(c, xfer_cmd & 0x1f);
+    if ((xfer_cmd & 0xe0) == NRF_W_REGISTER)
+        nrf_write(c, xfer_cmd & 0x1f, byte);
+    return 0;
+}
+
+static void nrf_cs_high(struct rf_chip *c)
+{
+    if ((xfer_cmd == NRF_W_TX_PAYLOAD || xfer_cmd == NRF24L01_B0_TX_PYLD_NOACK) && xfer_pos > 1) {
+        if ((c->reg[NRF24L01_00_CONFIG] & 0x03) == 0x02) {
+            c->reg[NRF24L01_07_STATUS] |= 0x20;  // TX_DS
+            rx_packet(NRF24L01, c->reg[NRF24L01_05_RF_CH], c->tx_fifo, c->tx_len);
+        }
+        c->tx_len = 0;
+    } else if (xfer_cmd == NRF_R_RX_PAYLOAD && xfer_pos > 1) {
+        c->rx_len = c->rx_pos = 0;
+    }
+}
+#endif
+
+void RFMODEL_SetPin(const struct mcu_pin *io, int state)
+{
+    for (int i = 0; i < RF_NUM_CHIPS; i++) {
+        if (io != &Transmitter.module_enable[i])
+            continue;
+        if (state) {
+            if (cs_module == i) {
+#ifdef PROTO_HAS_NRF24L01
+                if (i == NRF24L01)
+                    nrf_cs_high(&chip[i]);
+#endif
+                cs_module = -1;
+            }
+        } else {
+            cs_module = i;
+            xfer_pos = 0;
+        }
+        return;
+    }
+}
+
+u8 RFMODEL_Xfer(u8 byte)
+{
+    u8 res = 0;
+    if (cs_module < 0)
+        return 0;
+    struct rf_chip *c = &chip[(int)cs_module];
+    switch (cs_module) {
+#ifdef PROTO_HAS_CYRF6936
+    case CYRF6936: res = cyrf_xfer(c, byte); break;
+#endif
+#ifdef PROTO_HAS_A7105
+    case A7105:    res = a7105_xfer(c, byte); break;
+#endif
+#ifdef PROTO_HAS_CC2500
+    case CC2500:   res = cc2500_xfer(c, byte); break;
+#endif
+#ifdef PROTO_HAS_NRF24L01
+    case NRF24L01: res = nrf_xfer(c, byte); break;
+#endif
+    }
+    xfer_pos++;
+    return res;
+}
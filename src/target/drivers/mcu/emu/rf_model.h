@@ -0,0 +1,22 @@
+#ifndef _RF_MODEL_H_
+#define _RF_MODEL_H_
+
+/* Register-level models of the CYRF6936, A7105, CC2500 and NRF24L01
+ * used by the emulator in place of real transceivers.
+ * Transmitted packets are handed to a loopback receiver which keeps
+ * per-protocol statistics and, where a decoder exists, turns the packet
+ * back into channel values.
+ *
+ * Environment variables:
+ *   RFMODEL_DUMP=1       print every transmitted packet
+ *   RFMODEL_LOSS=<pct>   drop this percentage of packets at the receiver
+ *   RFMODEL_TELEM=<hex>  frame returned whenever the TX listens after a packet
+ */
+struct mcu_pin;
+
+void RFMODEL_SetPin(const struct mcu_pin *io, int state);
+u8 RFMODEL_Xfer(u8 byte);
+void RFMODEL_InjectRx(int module, const u8 *data, int len);
+void RFMODEL_InputChanged();
+
+#endif // _RF_MODEL_H_
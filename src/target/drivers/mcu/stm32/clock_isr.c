@@ -62,6 +62,9 @@ void __attribute__((__used__)) sys_tick_handler(void)
         nvic_set_pending_irq(NVIC_EXTI2_IRQ);
         return;
     }
+#if HAS_BUTTON_SCAN_ISR
+    ButtonMatrix_Tick(msecs);
+#endif
     if(msec_callbacks & (1 << MEDIUM_PRIORITY)) {
         //medium priority tasks execute in interrupt and main loop context
         if (msecs == msec_cbtime[MEDIUM_PRIORITY]) {
@@ -0,0 +1,71 @@
+/*
+ This project is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Deviation is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "dac_audio.h"
+
+static const s8 adpcm_index_table[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8,
+};
+
+static const u16 adpcm_step_table[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+    19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+    130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+    5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+/* Decode one mono IMA-ADPCM block: a 4 byte header holding the first
+ * sample and step index, followed by 2 samples per byte (low nibble first).
+ * Returns the number of samples passed to 'push' */
+unsigned ADPCM_DecodeBlock(const u8 *data, unsigned len, void (*push)(s16 sample))
+{
+    if (len < 4)
+        return 0;
+    int predictor = (s16)(data[0] | (data[1] << 8));
+    int index = data[2];
+    if (index > 88)
+        index = 88;
+    push(predictor);
+    for (unsigned i = 8; i < 2 * len; i++) {
+        unsigned nibble = (i & 1) ? data[i / 2] >> 4 : data[i / 2] & 0x0f;
+        int step = adpcm_step_table[index];
+        int diff = step >> 3;
+        if (nibble & 1) diff += step >> 2;
+        if (nibble & 2) diff += step >> 1;
+        if (nibble & 4) diff += step;
+        predictor += (nibble & 8) ? -diff : diff;
+        if (predictor > 32767)
+            predictor = 32767;
+        else if (predictor < -32768)
+            predictor = -32768;
+        index += adpcm_index_table[nibble];
+        if (index < 0)
+            index = 0;
+        else if (index > 88)
+            index = 88;
+        push(predictor);
+    }
+    return 2 * len - 7;
+}
+
+#define TESTNAME adpcm
+#include <tests.h>
@@ -18,23 +18,49 @@
 #include <libopencm3/stm32/i2c.h>
 
 #include "common.h"
-#include "target/common/stm32/nvic.h"
-#include "target/common/stm32/dma.h"
-#include "target/common/stm32/rcc.h"
+#include "target/drivers/mcu/stm32/nvic.h"
+#include "target/drivers/mcu/stm32/dma.h"
+#include "target/drivers/mcu/stm32/rcc.h"
+#include "target/drivers/mcu/stm32/tim.h"
+#include "dac_audio.h"
+
+/* Voice playback is split in two stages:
+ * AUDIODAC_Loop() reads the wav file in READ_CHUNK sized pieces, decodes
+ * PCM or IMA-ADPCM into 8-bit unsigned samples and stores them in the
+ * 'prefetch' ring.  The DMA interrupt copies samples from the ring into
+ * the half of 'waveform' which was just played, mixing in the tone
+ * generator.  A main-loop stall therefore only underruns once the whole
+ * prefetch ring (PREFETCH_SIZE samples) has been consumed.
+ */
+#define PREFETCH_SIZE   2048  // must be a power of 2
+#define READ_CHUNK      512
+#define DEFAULT_SAMPLE_RATE 16000
 
 enum {
-    AUDIO_DONE = 0,
-    AUDIO_FIRST_HALF = 1,
-    AUDIO_SECOND_HALF = 2,
-    AUDIO_READY = 3,
+    WAV_FORMAT_PCM = 1,
+    WAV_FORMAT_IMA_ADPCM = 0x11,
 };
-static uint8_t waveform[256];
-static volatile uint8_t load_audio;
+
+static u8 waveform[WAVEFORM_SIZE];
+static volatile u8 dac_running;
+static u32 dac_period;
+static u8 prefetch[PREFETCH_SIZE];
+static volatile u16 prefetch_head;  // only written by AUDIODAC_Loop
+static volatile u16 prefetch_tail;  // only written by the DMA isr
+static volatile u8 voice_loading;
 static FILE *  wav_fh;
 static uint32_t bytes_remaining;
+static uint32_t sample_rate;
+static uint16_t wav_format;
+static uint16_t block_align;
 static uint8_t sample_size;
 static uint8_t channel_size;
 
+static uint32_t tone_frequency;
+static uint32_t tone_phase;
+static volatile uint32_t tone_step;
+static volatile int8_t tone_amplitude;
+
 #define _uint32_le(x) (*(uint32_t *)(x))  // FIXME: need to do something different for Big-Endian
 #define _uint16_le(x) (*(uint16_t *)(x))  // FIXME: need to do something different for Big-Endian
 #define TIMER_TICKS_PER_SEC rcc_apb1_frequency
@@ -43,7 +69,7 @@ void AUDIODAC_Init(unsigned period)
 {
     /* Enable TIM2 clock. */
     rcc_periph_clock_enable(get_rcc_from_port(AUDIODAC_TIM.tim));
-    rcc_periph_reset_pulse(AUDIODAC_TIM.rst);
+    rcc_periph_reset_pulse(RST_TIMx(AUDIODAC_TIM.tim));
     /* Timer global mode: - No divider, Alignment edge, Direction up */
     timer_set_mode(AUDIODAC_TIM.tim, TIM_CR1_CKD_CK_INT,
                TIM_CR1_CMS_EDGE, TIM_CR1_DIR_UP);
@@ -64,26 +90,29 @@ void AUDIODAC_Init(unsigned period)
 
     /* DAC channel 1 uses DMA controller 1 Stream 5 Channel 7. */
     /* Enable AUDIODAC_DMA.dma clock and IRQ */
-        NVIC_enable_dma_irq(AUDIODAC_DMA);
-    DMA_stream_channel_reset(AUDIODAC_DMA.dma, AUDIODAC_DMA.stream, AUDIODAC_DMA.channel);
-    DMA_set_priority(AUDIODAC_DMA.dma, AUDIODAC_DMA.stream, DMA_SxCR_PL_LOW);
+    rcc_periph_clock_enable(get_rcc_from_port(AUDIODAC_DMA.dma));
+    nvic_enable_irq(get_nvic_dma_irq(AUDIODAC_DMA));
+    DMA_stream_reset(AUDIODAC_DMA);
+    DMA_set_priority(AUDIODAC_DMA, DMA_SxCR_PL_LOW);
     dma_set_memory_size(AUDIODAC_DMA.dma, AUDIODAC_DMA.stream, DMA_SxCR_MSIZE_8BIT);
     dma_set_peripheral_size(AUDIODAC_DMA.dma, AUDIODAC_DMA.stream, DMA_SxCR_PSIZE_8BIT);
     dma_enable_memory_increment_mode(AUDIODAC_DMA.dma, AUDIODAC_DMA.stream);
     dma_enable_circular_mode(AUDIODAC_DMA.dma, AUDIODAC_DMA.stream);
-    DMA_set_transfer_mode(AUDIODAC_DMA.dma, AUDIODAC_DMA.stream, AUDIODAC_DMA.channel,
-                DMA_SxCR_DIR_MEM_TO_PERIPHERAL);
+    DMA_set_transfer_mode(AUDIODAC_DMA, DMA_SxCR_DIR_MEM_TO_PERIPHERAL);
     /* The register to target is the DAC1 8-bit right justified data
        register */
     dma_set_peripheral_address(AUDIODAC_DMA.dma, AUDIODAC_DMA.stream, (uint32_t) &DAC_DHR8R1);
     /* The array v[] is filled with the waveform data to be output */
     dma_set_memory_address(AUDIODAC_DMA.dma, AUDIODAC_DMA.stream, (uint32_t) waveform);
-    dma_set_number_of_data(AUDIODAC_DMA.dma, AUDIODAC_DMA.stream, 256);
+    dma_set_number_of_data(AUDIODAC_DMA.dma, AUDIODAC_DMA.stream, WAVEFORM_SIZE);
     dma_enable_half_transfer_interrupt(AUDIODAC_DMA.dma, AUDIODAC_DMA.stream);
     dma_enable_transfer_complete_interrupt(AUDIODAC_DMA.dma, AUDIODAC_DMA.stream);
-    DMA_channel_select(AUDIODAC_DMA.dma, AUDIODAC_DMA.stream, AUDIODAC_DMA.channel);
-    DMA_enable_stream(AUDIODAC_DMA.dma, AUDIODAC_DMA.stream);
+    DMA_channel_select(AUDIODAC_DMA);
+    DMA_enable_stream(AUDIODAC_DMA);
 
+    /* The DAC output pin must be in analog mode */
+    rcc_periph_clock_enable(get_rcc_from_pin(AUDIODAC_PIN));
+    GPIO_setup_input(AUDIODAC_PIN, ITYPE_ANALOG);
     /* Enable the DAC clock on APB1 */
     rcc_periph_clock_enable(RCC_DAC);
     /* Setup the DAC channel 1, with timer 2 as trigger source.
@@ -92,6 +121,15 @@ void AUDIODAC_Init(unsigned period)
     dac_set_trigger_source(DAC_CR_TSEL1_T2);
     dac_dma_enable(CHANNEL_1);
     dac_enable(CHANNEL_1);
+    dac_running = 1;
+}
+
+void AUDIODAC_Stop()
+{
+    dma_disable_stream(AUDIODAC_DMA.dma, AUDIODAC_DMA.stream);
+    dac_disable(CHANNEL_1);
+    timer_disable_counter(AUDIODAC_TIM.tim);
+    dac_running = 0;
 }
 
 void I2CVOLUME_SET(unsigned volume) {
@@ -107,9 +145,49 @@ void I2CVOLUME_SET(unsigned volume) {
     vol[1] = volumeScale[volume];
     // FIXME: This hangs indefinitely
     // i2c_transfer7(I2C_CFG.i2c, I2C_ADDRESS_VOLUME, vol, 2,  NULL, 0);
+    (void)vol;
     return;
 }
 
+static uint8_t chunk[READ_CHUNK];
+
+static void push_sample(int16_t sample)
+{
+    prefetch[prefetch_head & (PREFETCH_SIZE - 1)] = (uint8_t)((sample >> 8) + 128);
+    prefetch_head++;
+}
+
+static void decode_pcm(const uint8_t *data, unsigned len)
+{
+    // Only the 1st channel is played
+    for (unsigned i = 0; i + sample_size <= len; i += sample_size) {
+        if (channel_size == 1)
+            push_sample((data[i] - 128) << 8);
+        else
+            push_sample((int16_t)_uint16_le(data + i));
+    }
+}
+
+static unsigned prefetch_space()
+{
+    return PREFETCH_SIZE - (uint16_t)(prefetch_head - prefetch_tail);
+}
+
+static unsigned max_samples_per_chunk()
+{
+    if (wav_format == WAV_FORMAT_IMA_ADPCM)
+        return 2 * block_align - 7;
+    return READ_CHUNK / sample_size;
+}
+
+static void close_voice()
+{
+    voice_loading = 0;
+    if (wav_fh) {
+        fclose(wav_fh);
+        wav_fh = NULL;
+    }
+}
 
 static uint32_t handle_fmt(uint32_t chunk_size)
 {
@@ -120,49 +198,133 @@ static uint32_t handle_fmt(uint32_t chunk_size)
     }
     fread(data, 16, 1, wav_fh);
 
-    unsigned format = _uint16_le(data);
-    uint32_t sample_rate = _uint32_le(data + 4);
-    sample_size = _uint16_le(data + 12);
+    wav_format = _uint16_le(data);
+    unsigned channels = _uint16_le(data + 2);
+    sample_rate = _uint32_le(data + 4);
+    block_align = _uint16_le(data + 12);
+    sample_size = block_align;
     channel_size = _uint16_le(data + 14) / 8;
     if (chunk_size > 16)
-        fseek(wav_fh, chunk_size, SEEK_CUR);
-    if (format != 1)
+        fseek(wav_fh, chunk_size - 16, SEEK_CUR);
+    if (!sample_rate || !block_align)
         return 0;
+    if (wav_format == WAV_FORMAT_IMA_ADPCM) {
+        if (channels != 1 || block_align > READ_CHUNK) {
+            printf("Unsupported ADPCM format\n");
+            return 0;
+        }
+    } else if (wav_format != WAV_FORMAT_PCM || !channel_size || channel_size > 2) {
+        return 0;
+    }
     unsigned period = TIMER_TICKS_PER_SEC / sample_rate;
     return period;
 }
 
 void AUDIODAC_Loop()
 {
-    u8 data[sizeof(waveform) / 2];
-    u8 *wavptr;
-    if (load_audio == AUDIO_DONE || load_audio == AUDIO_READY)
-        return;
-    wavptr = waveform + ((load_audio == AUDIO_FIRST_HALF) ? 0 : sizeof(waveform) / 2);
-    for (unsigned i = 0; i < channel_size; i++) {
-        unsigned len = sizeof(data);
+    // Read at most 2 chunks per call so a long file doesn't stall the main loop
+    for (int i = 0; i < 2 && voice_loading; i++) {
+        if (prefetch_space() < max_samples_per_chunk())
+            return;
+        unsigned len = (wav_format == WAV_FORMAT_IMA_ADPCM)
+                       ? block_align
+                       : READ_CHUNK - READ_CHUNK % sample_size;
         if (bytes_remaining < len)
             len = bytes_remaining;
-        unsigned bytes = fread(data, 1, len, wav_fh);
+        unsigned bytes = fread(chunk, 1, len, wav_fh);
         bytes_remaining -= bytes;
-        printf("br: %d %d\n", bytes_remaining, CLOCK_getms());
-        for (unsigned j = channel_size - 1; j < bytes; j += sample_size)
-            *wavptr++ = data[j];
-
-        if (!bytes_remaining) {
-            load_audio = AUDIO_DONE;
-            fclose(wav_fh);
-            wav_fh = NULL;
+        if (wav_format == WAV_FORMAT_IMA_ADPCM)
+            ADPCM_DecodeBlock(chunk, bytes, push_sample);
+        else
+            decode_pcm(chunk, bytes);
+        if (!bytes_remaining || bytes != len)
+            close_voice();
+    }
+}
+
+/* Fill 'buf' with the next voice samples mixed with the tone.
+ * Returns the number of voice samples consumed */
+static unsigned fill_buffer(uint8_t *buf, unsigned len)
+{
+    uint16_t tail = prefetch_tail;
+    unsigned avail = (uint16_t)(prefetch_head - tail);
+    if (avail > len)
+        avail = len;
+    int amplitude = tone_amplitude;
+    for (unsigned i = 0; i < len; i++) {
+        int sample = 0;
+        if (i < avail)
+            sample = prefetch[(tail + i) & (PREFETCH_SIZE - 1)] - 128;
+        if (amplitude) {
+            tone_phase += tone_step;
+            sample += (tone_phase & 0x80000000) ? amplitude : -amplitude;
+            if (sample > 127)
+                sample = 127;
+            else if (sample < -128)
+                sample = -128;
+        }
+        buf[i] = sample + 128;
+    }
+    prefetch_tail = tail + avail;
+    return avail;
+}
+
+int AUDIODAC_Busy()
+{
+    return voice_loading || prefetch_head != prefetch_tail || tone_amplitude;
+}
+
+/* Called from the DMA isr once half of the waveform buffer has been played.
+ * Samples are already decoded in RAM, so refilling here is just a copy
+ * and playback never waits for the main loop */
+void AUDIODAC_Refill(unsigned half)
+{
+    static u8 idle_halves;
+    if (!AUDIODAC_Busy()) {
+        // Stop once both halves have played out
+        if (++idle_halves >= 2) {
+            idle_halves = 0;
+            AUDIODAC_Stop();
             return;
         }
+    } else {
+        idle_halves = 0;
     }
-    load_audio = AUDIO_READY;
-    return;
+    fill_buffer(waveform + (half ? WAVEFORM_SIZE / 2 : 0), WAVEFORM_SIZE / 2);
+}
+
+static void start_dac()
+{
+    if (dac_running)
+        AUDIODAC_Stop();
+    dac_period = TIMER_TICKS_PER_SEC / sample_rate;
+    if (tone_frequency)
+        tone_step = ((uint64_t)tone_frequency << 32) / sample_rate;
+    fill_buffer(waveform, WAVEFORM_SIZE);
+    AUDIODAC_Init(dac_period);
+}
+
+void AUDIODAC_Tone(unsigned frequency, unsigned volume)
+{
+    if (!frequency || !volume) {
+        tone_amplitude = 0;
+        tone_frequency = 0;
+        return;
+    }
+    if (!dac_running)
+        sample_rate = DEFAULT_SAMPLE_RATE;
+    tone_frequency = frequency;
+    tone_step = ((uint64_t)frequency << 32) / sample_rate;
+    // Leave headroom for the voice when both are playing
+    tone_amplitude = (volume > 100 ? 100 : volume) * 63 / 100;
+    if (!dac_running)
+        start_dac();
 }
 
 void DAC_play(const char *filename)
 {
-    load_audio = AUDIO_DONE;
+    close_voice();
+    prefetch_head = prefetch_tail;
     wav_fh = fopen(filename, "r");
     if (!wav_fh) {
         printf("Failed to open wav\n");
@@ -172,6 +334,7 @@ void DAC_play(const char *filename)
     fread(data, 12, 1, wav_fh);
     if (memcmp(data, "RIFF", 4)) {
         printf("BAD WAV header\n");
+        close_voice();
         return;
     }
     u32 chunk_size;
@@ -179,7 +342,6 @@ void DAC_play(const char *filename)
     int ok;
     while ((ok = fread(data, 8, 1, wav_fh))) {
         chunk_size = _uint32_le(data + 4);
-        printf("read: %c%c%c%c %d\n", data[0], data[1], data[2], data[3], chunk_size);
         if (memcmp(data, "fmt ", 4) == 0) {
             period = handle_fmt(chunk_size);
         } else if (memcmp(data, "data", 4) != 0) {
@@ -190,13 +352,14 @@ void DAC_play(const char *filename)
     }
     if (!ok || !period) {
         printf("Missing data header\n");
+        close_voice();
         return;
     }
     bytes_remaining = chunk_size;
-    printf("period: %d ss: %d cs: %d count: %d\n", period, sample_size, channel_size, bytes_remaining);
-    load_audio = AUDIO_FIRST_HALF;
-    AUDIODAC_Loop();
-    load_audio = AUDIO_SECOND_HALF;
-    AUDIODAC_Loop();
-    AUDIODAC_Init(period);
+    voice_loading = 1;
+    // Fill the whole prefetch buffer before starting playback
+    while (voice_loading && prefetch_space() >= max_samples_per_chunk())
+        AUDIODAC_Loop();
+    if (!dac_running || period != dac_period)
+        start_dac();
 }
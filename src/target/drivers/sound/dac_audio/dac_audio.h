@@ -0,0 +1,15 @@
+#ifndef _DAC_AUDIO_H_
+#define _DAC_AUDIO_H_
+
+#define WAVEFORM_SIZE 256
+
+void AUDIODAC_Init(unsigned period);
+void AUDIODAC_Stop();
+void AUDIODAC_Loop();
+void AUDIODAC_Refill(unsigned half);
+int AUDIODAC_Busy();
+void AUDIODAC_Tone(unsigned frequency, unsigned volume);
+void DAC_play(const char *filename);
+unsigned ADPCM_DecodeBlock(const u8 *data, unsigned len, void (*push)(s16 sample));
+
+#endif  // _DAC_AUDIO_H_
@@ -18,29 +18,17 @@
 #include <libopencm3/stm32/i2c.h>
 
 #include "common.h"
-#include "target/common/stm32/nvic.h"
-#include "target/common/stm32/dma.h"
-#include "target/common/stm32/rcc.h"
+#include "target/drivers/mcu/stm32/nvic.h"
+#include "target/drivers/mcu/stm32/dma.h"
+#include "dac_audio.h"
 
-void dma1_stream5_isr(void)
+void AUDIODAC_DMA_ISR(void)
 {
-    PORT_pin_toggle(LED_RED_PIN);  // FIXME
-    // Do not load data into interrupt handler
-    if (load_audio == AUDIO_DONE) {
-        // All done
-        dma_clear_interrupt_flags(DMA1, DMA_STREAM5, DMA_HTIF);
-        dma_clear_interrupt_flags(DMA1, DMA_STREAM5, DMA_TCIF);
-        dma_disable_stream(AUDIODAC_DMA.dma, AUDIODAC_DMA.stream);
-        dac_disable(CHANNEL_1);
-        timer_disable_counter(AUDIODAC_TIM.tim);
-        return;
-    }
-    if (dma_get_interrupt_flag(DMA1, DMA_STREAM5, DMA_HTIF)) {
-        load_audio = AUDIO_FIRST_HALF;
-        dma_clear_interrupt_flags(DMA1, DMA_STREAM5, DMA_HTIF);
+    if (dma_get_interrupt_flag(AUDIODAC_DMA.dma, AUDIODAC_DMA.stream, DMA_HTIF)) {
+        dma_clear_interrupt_flags(AUDIODAC_DMA.dma, AUDIODAC_DMA.stream, DMA_HTIF);
+        AUDIODAC_Refill(0);
     } else {
-        load_audio = AUDIO_SECOND_HALF;
-        dma_clear_interrupt_flags(DMA1, DMA_STREAM5, DMA_TCIF);
+        dma_clear_interrupt_flags(AUDIODAC_DMA.dma, AUDIODAC_DMA.stream, DMA_TCIF);
+        AUDIODAC_Refill(1);
     }
 }
-
@@ -0,0 +1,63 @@
+/*
+ This project is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Deviation is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "dac_audio.h"
+
+/* Buzzer tones on targets without a piezo: the tone generator of the
+ * DAC driver plays the notes and is mixed with any voice playback */
+static u16(*Callback)();
+
+void SOUND_Init()
+{
+    VIBRATINGMOTOR_Init(); // Since the vibrating motor is tightly controlled by sound, we put its init() here instead of in the main()
+}
+
+void SOUND_SetFrequency(unsigned frequency, unsigned volume)
+{
+    AUDIODAC_Tone(frequency, volume);
+}
+
+void SOUND_Start(unsigned msec, u16(*next_note_cb)(), u8 vibrate)
+{
+    SOUND_StartWithoutVibrating(msec, next_note_cb);
+    if (vibrate)
+        VIBRATINGMOTOR_Start();
+}
+
+void SOUND_StartWithoutVibrating(unsigned msec, u16(*next_note_cb)())
+{
+    CLOCK_SetMsecCallback(TIMER_SOUND, msec);
+    Callback = next_note_cb;
+}
+
+void SOUND_Stop()
+{
+    CLOCK_ClearMsecCallback(TIMER_SOUND);
+    AUDIODAC_Tone(0, 0);
+    VIBRATINGMOTOR_Stop();
+}
+
+u32 SOUND_Callback()
+{
+    if (Callback == NULL) {  // To allow single tone
+        SOUND_Stop();
+        return 0;
+    }
+    unsigned msec = Callback();
+    if(! msec)
+        SOUND_Stop();
+    return msec;
+}
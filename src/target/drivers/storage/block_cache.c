@@ -0,0 +1,225 @@
+/*
+    This project is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Deviation is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "common.h"
+#include "block_cache.h"
+
+#if BLOCK_CACHE_BLOCKS
+
+#define FIFO_BLOCKS  (BLOCK_CACHE_BLOCKS / 2)               // A1in: blocks seen once
+#define LRU_BLOCKS   (BLOCK_CACHE_BLOCKS - FIFO_BLOCKS)     // Am: blocks seen again
+#define GHOST_BLOCKS BLOCK_CACHE_BLOCKS                     // A1out: tags recently dropped from the FIFO
+#define BS BLOCK_CACHE_BLOCK_SIZE
+
+ctassert(FIFO_BLOCKS > BLOCK_CACHE_READAHEAD, cache_too_small_for_readahead);
+
+/* dev is stored +1 so that an all-zero tag is an empty slot */
+struct tag {
+    u32 block;
+    u8 dev;
+};
+
+// The FIFO slots come first so that a read-ahead fills consecutive blocks
+static u8 data[BLOCK_CACHE_BLOCKS][BS];
+static struct tag tags[BLOCK_CACHE_BLOCKS];
+static u32 used[LRU_BLOCKS];
+static struct tag ghosts[GHOST_BLOCKS];
+static u8 fifo_head;
+static u8 ghost_head;
+static u32 lru_clock;
+static struct tag last;
+static struct blockcache_stats stats;
+
+static int match(const struct tag *t, u8 dev, u32 block)
+{
+    return t->dev == dev + 1 && t->block == block;
+}
+
+static int find(u8 dev, u32 block)
+{
+    for (int i = 0; i < BLOCK_CACHE_BLOCKS; i++) {
+        if (match(&tags[i], dev, block))
+            return i;
+    }
+    return -1;
+}
+
+static int take_ghost(u8 dev, u32 block)
+{
+    for (int i = 0; i < GHOST_BLOCKS; i++) {
+        if (match(&ghosts[i], dev, block)) {
+            ghosts[i].dev = 0;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void drop_fifo(int slot)
+{
+    if (tags[slot].dev) {
+        ghosts[ghost_head] = tags[slot];
+        ghost_head = (ghost_head + 1) % GHOST_BLOCKS;
+        tags[slot].dev = 0;
+    }
+}
+
+static int lru_victim()
+{
+    int victim = 0;
+    for (int i = 0; i < LRU_BLOCKS; i++) {
+        if (! tags[FIFO_BLOCKS + i].dev)
+            return FIFO_BLOCKS + i;
+        if (used[i] < used[victim])
+            victim = i;
+    }
+    return FIFO_BLOCKS + victim;
+}
+
+static void touch(int slot)
+{
+    if (slot >= FIFO_BLOCKS)
+        used[slot - FIFO_BLOCKS] = ++lru_clock;
+}
+
+/* Returns the cached copy of the block, reading it (and on a sequential
+ * miss the next few blocks too) if needed.  NULL on a read error
+ */
+static const u8 *get_block(u8 dev, blockcache_read_t read, u32 block)
+{
+    int sequential = match(&last, dev, block - 1);
+    last.dev = dev + 1;
+    last.block = block;
+
+    int slot = find(dev, block);
+    if (slot >= 0) {
+        stats.hits++;
+        touch(slot);
+        return data[slot];
+    }
+    stats.misses++;
+
+    if (take_ghost(dev, block)) {
+        // Missed again shortly after it left the FIFO: keep it for longer
+        slot = lru_victim();
+        tags[slot].dev = 0;
+        if (read(block, 1, data[slot]))
+            return NULL;
+        tags[slot].dev = dev + 1;
+        tags[slot].block = block;
+        touch(slot);
+        return data[slot];
+    }
+
+    unsigned count = 1;
+    if (sequential) {
+        unsigned max = FIFO_BLOCKS - fifo_head;
+        if (max > 1 + BLOCK_CACHE_READAHEAD)
+            max = 1 + BLOCK_CACHE_READAHEAD;
+        while (count < max && find(dev, block + count) < 0)
+            count++;
+    }
+    slot = fifo_head;
+    for (unsigned i = 0; i < count; i++)
+        drop_fifo(slot + i);
+    if (read(block, count, data[slot]))
+        return NULL;
+    for (unsigned i = 0; i < count; i++) {
+        tags[slot + i].dev = dev + 1;
+        tags[slot + i].block = block + i;
+    }
+    stats.readahead += count - 1;
+    fifo_head = (slot + count) % FIFO_BLOCKS;
+    return data[slot];
+}
+
+int BLOCKCACHE_Read(u8 dev, blockcache_read_t read, u32 block, u32 offset, u32 len, u8 *buf)
+{
+    block += offset / BS;
+    offset %= BS;
+    while (len) {
+        if (offset == 0 && len >= 2 * BS) {
+            // Large aligned reads would only push everything else out
+            unsigned count = len / BS;
+            if (read(block, count, buf))
+                return -1;
+            stats.bypass += count;
+            last.dev = dev + 1;
+            last.block = block + count - 1;
+            block += count;
+            buf += count * BS;
+            len -= count * BS;
+            continue;
+        }
+        const u8 *src = get_block(dev, read, block);
+        if (! src)
+            return -1;
+        u32 bytes = BS - offset;
+        if (bytes > len)
+            bytes = len;
+        memcpy(buf, src + offset, bytes);
+        buf += bytes;
+        len -= bytes;
+        offset = 0;
+        block++;
+    }
+    return 0;
+}
+
+/* Reads up to and including the next '\n'.  Returns the number of bytes read */
+u32 BLOCKCACHE_ReadStopCR(u8 dev, blockcache_read_t read, u32 block, u32 offset, u32 len, u8 *buf)
+{
+    u32 total = 0;
+    block += offset / BS;
+    offset %= BS;
+    while (total < len) {
+        const u8 *src = get_block(dev, read, block);
+        if (! src)
+            break;
+        for (; offset < BS && total < len; offset++) {
+            buf[total++] = src[offset];
+            if (src[offset] == '\n')
+                return total;
+        }
+        offset = 0;
+        block++;
+    }
+    return total;
+}
+
+/* Must be called for every write or erase which bypasses the cache */
+void BLOCKCACHE_Invalidate(u8 dev, u32 block, u32 count)
+{
+    for (int i = 0; i < BLOCK_CACHE_BLOCKS; i++) {
+        if (tags[i].dev == dev + 1 && tags[i].block - block < count)
+            tags[i].dev = 0;
+    }
+}
+
+void BLOCKCACHE_Flush()
+{
+    memset(tags, 0, sizeof(tags));
+    memset(ghosts, 0, sizeof(ghosts));
+    last.dev = 0;
+}
+
+void BLOCKCACHE_Stats(struct blockcache_stats *s)
+{
+    *s = stats;
+}
+
+#define TESTNAME block_cache
+#include <tests.h>
+
+#endif //BLOCK_CACHE_BLOCKS
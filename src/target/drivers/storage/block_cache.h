@@ -0,0 +1,44 @@
+#ifndef _BLOCK_CACHE_H_
+#define _BLOCK_CACHE_H_
+
+/* Read cache shared by the filesystems that sit on SPI flash or MMC.
+ * Blocks are BLOCK_CACHE_BLOCK_SIZE bytes and are addressed by block number
+ * per device.  Replacement is 2Q: new blocks enter a FIFO, and only blocks
+ * that are missed again shortly after leaving it (the 'ghost' list) move to
+ * the LRU part, so a single pass over a large file can't flush the FAT and
+ * directory blocks.  Sequential misses read BLOCK_CACHE_READAHEAD extra
+ * blocks in the same transfer.
+ * Define BLOCK_CACHE_BLOCKS in target_defs.h, 0 disables the cache.
+ */
+#ifndef BLOCK_CACHE_BLOCKS
+    #define BLOCK_CACHE_BLOCKS 0
+#endif
+#ifndef BLOCK_CACHE_BLOCK_SIZE
+    #define BLOCK_CACHE_BLOCK_SIZE 256
+#endif
+#ifndef BLOCK_CACHE_READAHEAD
+    #define BLOCK_CACHE_READAHEAD 1
+#endif
+
+/* Reads 'count' whole blocks, returns 0 on success */
+typedef int (*blockcache_read_t)(u32 block, unsigned count, u8 *buf);
+
+struct blockcache_stats {
+    u32 hits;
+    u32 misses;
+    u32 readahead;   // blocks read ahead of a sequential miss
+    u32 bypass;      // blocks of large reads which went straight to the device
+};
+
+#if BLOCK_CACHE_BLOCKS
+int BLOCKCACHE_Read(u8 dev, blockcache_read_t read, u32 block, u32 offset, u32 len, u8 *buf);
+u32 BLOCKCACHE_ReadStopCR(u8 dev, blockcache_read_t read, u32 block, u32 offset, u32 len, u8 *buf);
+void BLOCKCACHE_Invalidate(u8 dev, u32 block, u32 count);
+void BLOCKCACHE_Flush();
+void BLOCKCACHE_Stats(struct blockcache_stats *stats);
+#else
+static inline void BLOCKCACHE_Invalidate(u8 dev, u32 block, u32 count) { (void)dev; (void)block; (void)count; }
+static inline void BLOCKCACHE_Flush() {}
+#endif
+
+#endif //_BLOCK_CACHE_H_
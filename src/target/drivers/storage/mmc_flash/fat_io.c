@@ -22,6 +22,7 @@
 #include <string.h>
 #include <stdio.h>
 #include "FatFs/diskio.h"
+#include "target/drivers/storage/block_cache.h"
 
 #include <libopencm3/stm32/spi.h>
 #include <libopencm3/stm32/dma.h>
@@ -66,6 +67,10 @@
 #define CT_SDC              (CT_SD1|CT_SD2)
 #define CT_BLOCK            0x08
 
+#if BLOCK_CACHE_BLOCKS
+ctassert(BLOCK_CACHE_BLOCK_SIZE == 512, block_cache_uses_sectors);
+#endif
+
 
 u8 _drive_num;    // This isn't actually used for anything, but is referenced in syscalls.c
 /*uint32_t Card_ID[4] ;
@@ -517,6 +522,7 @@ DSTATUS disk_initialize(
     printf("Volume: %d Stat: %d\n", drv, Stat);
         if (drv) return STA_NOINIT;                     /* Supports only single drive */
         if (Stat & STA_NODISK) return Stat;     /* No card in the socket */
+        BLOCKCACHE_Flush();                     /* The card may have been swapped */
 
         power_on();                                                     /* Force socket power on and initialize interface */
         interface_speed(INTERFACE_SLOW);
@@ -599,25 +605,9 @@ int8_t SD_ReadSectors(uint8_t *buff, uint32_t sector, uint32_t count)
   return 0;
 }
 
-/*---------------------------------------------------------------------------*/
-/** @brief Read Disk Sectors
-
-@param[in] drv: BYTE Physical drive number (only 0 allowed)
-@param[in] *buff: BYTE Pointer to buffer
-@param[in] sector: DWORD starting sector number
-@param[in] count: BYTE number of sectors to read
-@returns DRESULT success (RES_OK) or fail.
-*/
-DRESULT disk_read(
-        BYTE drv,                       /* Physical drive number (0) */
-        BYTE *buff,                     /* Pointer to the data buffer to store read data */
-        DWORD sector,           /* Start sector number (LBA) */
-        UINT count                      /* Sector count (1..255) */
-)
+/* Reads whole sectors, returns the number of sectors which could not be read */
+static int read_sectors(u32 sector, unsigned count, u8 *buff)
 {
-        if (drv || !count) return RES_PARERR;
-        if (Stat & STA_NOINIT) return RES_NOTRDY;
-
         if (!(CardType & CT_BLOCK)) sector *= 512;      /* Convert to byte address if needed */
 
         if (count == 1) {       /* Single block read */
@@ -639,7 +629,33 @@ DRESULT disk_read(
         }
         release_spi();
 
-        return count ? RES_ERROR : RES_OK;
+        return count;
+}
+
+/*---------------------------------------------------------------------------*/
+/** @brief Read Disk Sectors
+
+@param[in] drv: BYTE Physical drive number (only 0 allowed)
+@param[in] *buff: BYTE Pointer to buffer
+@param[in] sector: DWORD starting sector number
+@param[in] count: BYTE number of sectors to read
+@returns DRESULT success (RES_OK) or fail.
+*/
+DRESULT disk_read(
+        BYTE drv,                       /* Physical drive number (0) */
+        BYTE *buff,                     /* Pointer to the data buffer to store read data */
+        DWORD sector,           /* Start sector number (LBA) */
+        UINT count                      /* Sector count (1..255) */
+)
+{
+        if (drv || !count) return RES_PARERR;
+        if (Stat & STA_NOINIT) return RES_NOTRDY;
+
+#if BLOCK_CACHE_BLOCKS
+        return BLOCKCACHE_Read(0, read_sectors, sector, 0, count * 512, buff) ? RES_ERROR : RES_OK;
+#else
+        return read_sectors(sector, count, buff) ? RES_ERROR : RES_OK;
+#endif
 }
 
 
@@ -652,6 +668,7 @@ DRESULT disk_read(
 
 int8_t SD_WriteSectors(uint8_t *buff, uint32_t sector, uint32_t count)
 {
+  BLOCKCACHE_Invalidate(0, sector, count);
   if (!(CardType & CT_BLOCK)) sector *= 512;      /* Convert to byte address if needed */
   if (CardType & CT_SDC) send_cmd(ACMD23, count);
   if (send_cmd(CMD25, sector) == 0) {     /* WRITE_MULTIPLE_BLOCK */
@@ -688,6 +705,7 @@ DRESULT disk_write(
         if (Stat & STA_NOINIT) return RES_NOTRDY;
         if (Stat & STA_PROTECT) return RES_WRPRT;
 
+        BLOCKCACHE_Invalidate(0, sector, count);
         if (!(CardType & CT_BLOCK)) sector *= 512;      /* Convert to byte address if needed */
 
         if (count == 1) {       /* Single block write */
@@ -5,6 +5,7 @@
 
 #include "common.h"
 #include "devo_usb.h"
+#include "target/drivers/storage/block_cache.h"
 
 static const char * const usb_strings[] = {
     USB_Product_Name,
@@ -152,6 +153,8 @@ int MSC_Write(uint32_t lba, const u8 *Writebuff, uint16_t offset, uint16_t Trans
     }
 #endif
 
+    // The filesystem read cache doesn't see writes from the host
+    BLOCKCACHE_Flush();
     if (offset == 0) {
         STORAGE_EraseSector(Memory_Offset + ((SPIFLASH_SECTOR_OFFSET - FAT_OFFSET) * 0x1000));
     }
@@ -33,6 +33,14 @@ static inline void LCD_ForceUpdate() {}
 
 #define FLASHTYPE FLASHTYPE_SPI
 
+#ifndef BLOCK_CACHE_BLOCKS
+    #define BLOCK_CACHE_BLOCKS 8
+#endif
+
+#ifndef EMULATOR
+    #define HAS_BUTTON_SCAN_ISR 1
+#endif
+
 #ifndef HAS_HARD_POWER_OFF
 #define HAS_HARD_POWER_OFF 0
 #endif
@@ -82,6 +82,8 @@
         .csn = {GPIOB, GPIO0},          \
         })
     #define LCD_SPI_MODE ((struct mcu_pin) {GPIOC, GPIO5})
+    // SPI1_TX is hardwired to DMA1 channel 3 which PWM_DMA owns, so
+    // LCD_SPI_TX_DMA is left undefined and runs are written by hand
     #ifndef SPI1_CFG
         #define SPI1_CFG ((struct spi_config) {   \
             .spi = SPI1,                          \
@@ -112,6 +114,11 @@
     #endif
     #define PROTO_SPI_CFG SPI2_CFG
     #define PROTO_RST_PIN ((struct mcu_pin){GPIOB, GPIO11})
+    // SPI2_TX request is hardwired to DMA1 channel 5
+    #define PROTO_SPI_TX_DMA ((struct dma_config) { \
+        .dma = DMA1,                       \
+        .stream = DMA_CHANNEL5,            \
+        })
 #endif  // PROTO_SPI
 
 #ifndef TOUCH_SPI
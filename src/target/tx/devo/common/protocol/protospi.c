@@ -4,9 +4,14 @@
 
 #include <libopencm3/stm32/gpio.h>
 #include <libopencm3/stm32/spi.h>
+#include <libopencm3/stm32/dma.h>
 #include <libopencm3/cm3/cortex.h>
 
 #include "common.h"
+#include "target/drivers/mcu/stm32/dma.h"
+
+// Bursts shorter than this are faster to feed by hand than to set up DMA for
+#define PROTOSPI_DMA_MIN 16
 
 u8 PROTOSPI_read3wire(){
     u8 data;
@@ -31,3 +36,59 @@ u8 PROTOSPI_read3wire(){
     spi_enable(PROTO_SPI.spi);
     return data;
 }
+
+/* Wait for the last byte to leave the shift register and throw away
+ * whatever was clocked in meanwhile.  Reading DR then SR clears OVR so
+ * the next PROTOSPI_xfer() sees a clean RXNE. */
+static void _write_finish()
+{
+    while (!(SPI_SR(PROTO_SPI.spi) & SPI_SR_TXE))
+        ;
+    while ((SPI_SR(PROTO_SPI.spi) & SPI_SR_BSY))
+        ;
+    volatile u8 x = SPI_DR(PROTO_SPI.spi);
+    x = SPI_SR(PROTO_SPI.spi);
+    (void)x;
+}
+
+#ifdef PROTO_SPI_TX_DMA
+static void _write_dma(const u8 *data, int len)
+{
+    DMA_stream_reset(PROTO_SPI_TX_DMA);
+    dma_set_peripheral_address(PROTO_SPI_TX_DMA.dma, PROTO_SPI_TX_DMA.stream, (u32) &SPI_DR(PROTO_SPI.spi));
+    dma_set_memory_address(PROTO_SPI_TX_DMA.dma, PROTO_SPI_TX_DMA.stream, (u32) data);
+    dma_set_number_of_data(PROTO_SPI_TX_DMA.dma, PROTO_SPI_TX_DMA.stream, len);
+    dma_set_read_from_memory(PROTO_SPI_TX_DMA.dma, PROTO_SPI_TX_DMA.stream);
+    dma_enable_memory_increment_mode(PROTO_SPI_TX_DMA.dma, PROTO_SPI_TX_DMA.stream);
+    dma_set_peripheral_size(PROTO_SPI_TX_DMA.dma, PROTO_SPI_TX_DMA.stream, DMA_SxCR_PSIZE_8BIT);
+    dma_set_memory_size(PROTO_SPI_TX_DMA.dma, PROTO_SPI_TX_DMA.stream, DMA_SxCR_MSIZE_8BIT);
+    dma_set_priority(PROTO_SPI_TX_DMA.dma, PROTO_SPI_TX_DMA.stream, DMA_CCR_PL_HIGH);
+    DMA_channel_select(PROTO_SPI_TX_DMA);
+    DMA_enable_stream(PROTO_SPI_TX_DMA);
+    spi_enable_tx_dma(PROTO_SPI.spi);
+    while (!dma_get_interrupt_flag(PROTO_SPI_TX_DMA.dma, PROTO_SPI_TX_DMA.stream, DMA_TCIF))
+        ;
+    spi_disable_tx_dma(PROTO_SPI.spi);
+    DMA_disable_stream(PROTO_SPI_TX_DMA);
+    dma_clear_interrupt_flags(PROTO_SPI_TX_DMA.dma, PROTO_SPI_TX_DMA.stream, DMA_TCIF);
+}
+#endif
+
+/* Write a block without waiting for each byte to be echoed back.
+ * The chip-select must already be low; received data is discarded. */
+void PROTOSPI_write(const u8 *data, int len)
+{
+#ifdef PROTO_SPI_TX_DMA
+    if (len >= PROTOSPI_DMA_MIN) {
+        _write_dma(data, len);
+        _write_finish();
+        return;
+    }
+#endif
+    for (int i = 0; i < len; i++) {
+        while (!(SPI_SR(PROTO_SPI.spi) & SPI_SR_TXE))
+            ;
+        SPI_DR(PROTO_SPI.spi) = data[i];
+    }
+    _write_finish();
+}
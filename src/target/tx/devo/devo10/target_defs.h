@@ -57,6 +57,9 @@
 #define VOLTAGE_NUMERATOR 324
 #define VOLTAGE_OFFSET    421
 
+// The LCD driver batches its flush into GUI refreshes
+#define LCD_ForceUpdate LCD_ForceUpdate
+
 #include "hardware.h"
 #include "../common/common_devo.h"
 
@@ -62,6 +62,9 @@
 #define VOLTAGE_NUMERATOR 216
 #define VOLTAGE_OFFSET    249
 
+// The LCD driver batches its flush into GUI refreshes
+#define LCD_ForceUpdate LCD_ForceUpdate
+
 #include "hardware.h"
 #include "../common/common_devo.h"
 
@@ -38,6 +38,9 @@
 #define SUPPORT_XN297DUMP 0
 
 #define DEBUG_WINDOW_SIZE 0
+#define BLOCK_CACHE_BLOCKS 0
+#define FS_OPEN_FILES 2
+#define CONFIG_WRITE_BUFFER 128
 #define MIN_BRIGHTNESS 0
 #define DEFAULT_BATTERY_ALARM 4100
 #define DEFAULT_BATTERY_CRITICAL 3900
@@ -58,6 +61,9 @@
 #define VOLTAGE_NUMERATOR 216
 #define VOLTAGE_OFFSET    249
 
+// The LCD driver batches its flush into GUI refreshes
+#define LCD_ForceUpdate LCD_ForceUpdate
+
 #include "hardware.h"
 #include "../common/common_devo.h"
 
@@ -43,6 +43,9 @@
 #define SUPPORT_MULTI_LANGUAGE 0
 
 #define DEBUG_WINDOW_SIZE 0
+#define BLOCK_CACHE_BLOCKS 0
+#define FS_OPEN_FILES 2
+#define CONFIG_WRITE_BUFFER 128
 #define MIN_BRIGHTNESS 0
 #define DEFAULT_BATTERY_ALARM 6600
 #define DEFAULT_BATTERY_CRITICAL 6200
@@ -167,6 +167,7 @@
     .stream = DMA_STREAM5,        \
     .channel = DMA_SxCR_CHSEL_7,  \
     })
+#define AUDIODAC_DMA_ISR dma1_stream5_isr
 
 #define AUDIODAC_PIN ((struct mcu_pin) {GPIOA, GPIO4})
 #define I2C_CFG ((struct i2c_config) { \
@@ -178,7 +179,9 @@
 
 #define PROTO_SPI_CFG ((struct spi_config) {})
 
-#define AUDIODAC_TIM TIM_CFG(2)  // TIM2
+#define AUDIODAC_TIM ((struct tim_config) { \
+    .tim = TIM2,                 \
+    })
 #include "target/drivers/mcu/stm32/hardware.h"
 
 #endif  // _HARDWARE_H_
@@ -6,6 +6,7 @@
 
 u8 PROTOSPI_read3wire();
 u8 PROTOSPI_xfer(u8 byte);
+void PROTOSPI_write(const u8 *data, int len);
 #define PROTOSPI_pin_set(io) GPIO_pin_set(io)
 #define PROTOSPI_pin_clear(io) GPIO_pin_clear(io)
 #define PROTOSPI_pin_get(io) GPIO_pin_get(io)
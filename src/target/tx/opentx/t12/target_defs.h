@@ -2,6 +2,8 @@
 #define _T12_TARGET_H_
 
 #define FLASHTYPE FLASHTYPE_MMC
+#define BLOCK_CACHE_BLOCKS 16
+#define BLOCK_CACHE_BLOCK_SIZE 512
 #if defined(EMULATOR) && EMULATOR == USE_NATIVE_FS
     #include "enable_native_fs.h"
 #else
@@ -90,9 +92,8 @@ extern void PROTO_Stubs(int);
 #define NUM_ADC_CHANNELS (INP_HAS_CALIBRATION + 2)  // Inputs + Temprature + Voltage
 extern volatile u16 adc_array_raw[NUM_ADC_CHANNELS];
 void ADC_Filter();
-#ifndef LCD_ForceUpdate
-static inline void LCD_ForceUpdate() {}
-#endif
+// The LCD driver batches its flush into GUI refreshes
+#define LCD_ForceUpdate LCD_ForceUpdate
 
 
 #endif  // _T12_TARGET_H_
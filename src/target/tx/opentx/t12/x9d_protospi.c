@@ -5,6 +5,7 @@
 int SPI_ProtoGetPinConfig(int module, int state) {(void)module; (void)state; return 0;}
 u8 PROTOSPI_read3wire() { return 0x00; }
 u8 PROTOSPI_xfer(u8 byte) { return byte; }
+void PROTOSPI_write(const u8 *data, int len) { (void)data; (void)len; }
 void SPI_ProtoInit() {}
 int MCU_SetPin(struct mcu_pin *port, const char *name) {return 0;}
 void MCU_InitModules() {}
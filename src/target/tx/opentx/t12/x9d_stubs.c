@@ -34,22 +34,6 @@ void HID_Write(s8 *pkt, u8 size) {
     (void)size;
 }
 volatile u8 HID_prevXferComplete;
-void SOUND_Init() {}
-void SOUND_SetFrequency(unsigned frequency, unsigned volume) {
-    (void)frequency;
-    (void)volume;
-}
-void SOUND_Start(unsigned msec, u16(*next_note_cb)(), u8 vibrate) {
-    (void)msec;
-    (void)next_note_cb;
-    (void)vibrate;
-}
-void SOUND_StartWithoutVibrating(unsigned msec, u16(*next_note_cb)()) {
-    (void)msec;
-    (void)next_note_cb;
-}
-void SOUND_Stop() {}
-u32 SOUND_Callback() { return 0;}
 
 void SPIFlash_Init() {}
 void SPI_FlashBlockWriteEnable(unsigned enable) {
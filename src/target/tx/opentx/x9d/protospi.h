@@ -6,6 +6,7 @@
 
 u8 PROTOSPI_read3wire();
 u8 PROTOSPI_xfer(u8 byte);
+void PROTOSPI_write(const u8 *data, int len);
 #define PROTOSPI_pin_set(io) gpio_set((io).port, (io).pin)
 #define PROTOSPI_pin_clear(io) gpio_clear((io).port, (io).pin)
 #define _NOP(n) asm volatile ("nop")
@@ -101,6 +101,12 @@ u8 PROTOSPI_xfer(u8 tx)
     return rx;
 }
 
+void PROTOSPI_write(const u8 *data, int len)
+{
+    for (int i = 0; i < len; i++)
+        PROTOSPI_xfer(data[i]);
+}
+
 #if HAS_MULTIMOD_SUPPORT
 int SPI_ConfigSwitch(unsigned csn_high, unsigned csn_low)
 {
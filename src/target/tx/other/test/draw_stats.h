@@ -0,0 +1,13 @@
+#ifndef _DRAW_STATS_H_
+#define _DRAW_STATS_H_
+
+/* Drawing and file access counters, reset by the tests around a render */
+struct draw_stats {
+    u32 pixels;        // pixels pushed to the LCD
+    u32 windows;       // address window changes (LCD_DrawStart/LCD_DrawPixelXY)
+    u32 file_opens;
+    u32 file_bytes;    // bytes read through fread/fgets
+};
+extern struct draw_stats draw_stats;
+
+#endif // _DRAW_STATS_H_
@@ -3,6 +3,8 @@
 
 #include "gui/gui.h"
 
+#include "draw_stats.h"
+
 #define LCD_WIDTH_MULT 1
 #define LCD_HEIGHT_MULT 1
 #define EMU_STRING "Unittest"
@@ -16,6 +16,8 @@
 #include "common.h"
 #include "emu.h"
 
+struct draw_stats draw_stats;
+
 void LCD_Init()
 {
     memset(gui.image, 0xf0, sizeof(gui.image));
@@ -37,6 +39,7 @@ void LCD_DrawStart(unsigned int x0, unsigned int y0, unsigned int x1, unsigned i
     gui.xstart = x0;
     gui.xend = x1;
     gui.x = x0;
+    draw_stats.windows++;
 }
 
 void LCD_DrawStop(void) {
@@ -47,11 +50,13 @@ void LCD_DrawPixelXY(unsigned int x, unsigned int y, unsigned int color)
     gui.xstart = x;
     gui.x = x;
     gui.y = y;
+    draw_stats.windows++;
     LCD_DrawPixel(color);
 }
 
 void LCD_DrawPixel(unsigned int color)
 {
+    draw_stats.pixels++;
 	if (gui.x < LCD_WIDTH && gui.y < LCD_HEIGHT) {	// both are unsigned, can not be < 0
 		u8 r, g, b;
 		r = (color >> 8) & 0xf8;
@@ -1,12 +1,30 @@
 #ifndef _SPIPROTO_H_
 #define _SPIPROTO_H_
 
+struct mcu_pin;
+
 u8 PROTOSPI_read3wire();
 u8 PROTOSPI_xfer(u8 byte);
-#define PROTOSPI_pin_set(io) if (0) {}
-#define PROTOSPI_pin_clear(io) if (0) {}
+void PROTOSPI_write(const u8 *data, int len);
+void PROTOSPI_pin_trace(const struct mcu_pin *io, int state);
+#define PROTOSPI_pin_set(io) PROTOSPI_pin_trace(&(io), 1)
+#define PROTOSPI_pin_clear(io) PROTOSPI_pin_trace(&(io), 0)
 #define _NOP() if(0) {}
 
+/* Bus recorder used by the protocol regression tests.
+ * While enabled every chip-select cycle, UART/PPM/PXX frame and timer
+ * change is appended to an in-memory text trace, one event per line. */
+void TRACE_Start();
+const char *TRACE_Stop();
+int TRACE_Enabled();
+void TRACE_Log(const char *fmt, ...);
+void TRACE_Bytes(const char *tag, const u8 *data, int len);
+unsigned TRACE_SPIBytes();
+
+#undef CYRF_RESET_PIN
+#undef AVR_RESET_PIN
+#define CYRF_RESET_PIN ((struct mcu_pin){0, 0})
+#define AVR_RESET_PIN ((struct mcu_pin){0, 0})
 #define _SPI_CYRF_RESET_PIN {0, 0}
 #define _SPI_AVR_RESET_PIN {0, 0}
 #pragma weak A7105_Reset
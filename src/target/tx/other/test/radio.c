@@ -17,7 +17,9 @@
 #include "protocol/interface.h"
 #include "config/model.h"
 #include "config/tx.h"
+#include "protospi.h"
 
+#include <stdarg.h>
 #include <stdlib.h>
 
 #define GPIOA 0xAAAAAAAA
@@ -123,9 +125,145 @@ int SPI_ProtoGetPinConfig(int module, int state) {
     return 0;
 }
 
+/* Trace recorder
+ * SPI bytes are collected between a module's CS going low and high again
+ * and written out as a single line: "<module> <byte> <byte> ..."
+ */
+#define TRACE_MAX_XFER 256
+static struct {
+    char *buf;
+    unsigned len;
+    unsigned size;
+    unsigned spi_bytes;
+    u8 enabled;
+    s8 module;          // module whose CS is low, -1 if none
+    u16 xfer_len;
+    u8 xfer[TRACE_MAX_XFER];
+} trace;
+
+static void trace_append(const char *str, unsigned len)
+{
+    if (trace.len + len + 1 > trace.size) {
+        trace.size = (trace.len + len + 1) * 2;
+        trace.buf = realloc(trace.buf, trace.size);
+    }
+    memcpy(trace.buf + trace.len, str, len);
+    trace.len += len;
+    trace.buf[trace.len] = 0;
+}
+
+void TRACE_Log(const char *fmt, ...)
+{
+    char line[1024];
+    va_list ap;
+    if (! trace.enabled)
+        return;
+    va_start(ap, fmt);
+    int len = vsnprintf(line, sizeof(line) - 1, fmt, ap);
+    va_end(ap);
+    if (len > (int)sizeof(line) - 2)
+        len = sizeof(line) - 2;
+    line[len++] = '\n';
+    trace_append(line, len);
+}
+
+void TRACE_Bytes(const char *tag, const u8 *data, int len)
+{
+    static const char hex[] = "0123456789abcdef";
+    char line[3 * TRACE_MAX_XFER + 1];
+    char *ptr = line;
+    if (! trace.enabled)
+        return;
+    if (len > TRACE_MAX_XFER)
+        len = TRACE_MAX_XFER;
+    for (int i = 0; i < len; i++) {
+        *ptr++ = ' ';
+        *ptr++ = hex[data[i] >> 4];
+        *ptr++ = hex[data[i] & 0x0f];
+    }
+    *ptr = 0;
+    TRACE_Log("%s%s", tag, line);
+}
+
+void TRACE_Start()
+{
+    trace.len = 0;
+    trace.spi_bytes = 0;
+    trace.module = -1;
+    trace.xfer_len = 0;
+    trace.enabled = 1;
+    trace_append("", 0);
+}
+
+const char *TRACE_Stop()
+{
+    trace.enabled = 0;
+    return trace.buf;
+}
+
+int TRACE_Enabled()
+{
+    return trace.enabled;
+}
+
+unsigned TRACE_SPIBytes()
+{
+    return trace.spi_bytes;
+}
+
+static void trace_flush_xfer()
+{
+    if (trace.xfer_len || trace.module >= 0)
+        TRACE_Bytes(trace.module >= 0 ? MODULE_NAME[(int)trace.module] : "SPI",
+                    trace.xfer, trace.xfer_len);
+    trace.xfer_len = 0;
+}
+
+static void trace_xfer(u8 byte)
+{
+    if (! trace.enabled)
+        return;
+    trace.spi_bytes++;
+    if (trace.xfer_len == TRACE_MAX_XFER)
+        trace_flush_xfer();
+    trace.xfer[trace.xfer_len++] = byte;
+}
+
+void PROTOSPI_pin_trace(const struct mcu_pin *io, int state)
+{
+    if (! trace.enabled)
+        return;
+    for (int i = 0; i < TX_MODULE_LAST; i++) {
+        if (io == &Transmitter.module_enable[i]) {
+            if (state) {
+                if (trace.module == i) {
+                    trace_flush_xfer();
+                    trace.module = -1;
+                }
+            } else {
+                if (trace.module != i)
+                    trace_flush_xfer();
+                trace.module = i;
+            }
+            return;
+        }
+    }
+    TRACE_Log("PIN %08x:%04x %d", (unsigned)io->port, (unsigned)io->pin, state);
+}
+
 u8 PROTOSPI_read3wire() { return 0x00; }
 
-u8 PROTOSPI_xfer(u8 byte) { return byte; }
+u8 PROTOSPI_xfer(u8 byte)
+{
+    trace_xfer(byte);
+    return byte;
+}
+
+void PROTOSPI_write(const u8 *data, int len)
+{
+    for (int i = 0; i < len; i++)
+        trace_xfer(data[i]);
+}
 
 #ifdef PROTO_HAS_A7105
 int A7105_Reset() { return 1; }
@@ -143,6 +281,10 @@ void PWM_Stop() {}
 void PPM_Enable(unsigned active_time, volatile u16 *pulses, u8 num_pulses, u8 polarity) {
     (void)polarity;
     int i;
+    if (TRACE_Enabled()) {
+        TRACE_Bytes("PPM", (const u8 *)pulses, num_pulses * sizeof(u16));
+        return;
+    }
     printf("PPM: low=%d ", (int)active_time);
     for(i = 0; i < num_pulses; i++)
         printf("%04d ", pulses[i]);
@@ -16,6 +16,7 @@
 #include "mixer.h"
 #include "config/tx.h"
 #include "emu.h"
+#include "protospi.h"
 
 void start_event_loop()
 {
@@ -63,14 +64,17 @@ void SPITouch_Calibrate(s32 xscale, s32 yscale, s32 xoff, s32 yoff)
 void CLOCK_Init()
 {
 }
+/* The protocol timer isn't run here, the tests call timer_callback directly */
+u16 (*timer_callback)(void);
 void CLOCK_StartTimer(unsigned us, u16 (*cb)(void))
 {
-    (void)us;
-    (void)cb;
+    timer_callback = cb;
+    TRACE_Log("TIMER %u", us);
 }
 
 void CLOCK_StopTimer()
 {
+    timer_callback = NULL;
 }
 
 void CLOCK_SetMsecCallback(int cb, u32 msec)
@@ -94,8 +98,38 @@ void PWR_Sleep()
 }
 
 void _usleep(u32 usec) {
+    if (TRACE_Enabled()) {
+        TRACE_Log("DELAY %u", (unsigned)usec);
+        return;
+    }
     usleep(usec);
 }
+
+FILE *__real_fopen(const char *path, const char *mode);
+size_t __real_fread(void *ptr, size_t size, size_t nmemb, FILE *stream);
+char *__real_fgets(char *s, int size, FILE *stream);
+
+FILE *__wrap_fopen(const char *path, const char *mode)
+{
+    draw_stats.file_opens++;
+    return __real_fopen(path, mode);
+}
+
+size_t __wrap_fread(void *ptr, size_t size, size_t nmemb, FILE *stream)
+{
+    size_t count = __real_fread(ptr, size, nmemb, stream);
+    draw_stats.file_bytes += count * size;
+    return count;
+}
+
+char *__wrap_fgets(char *s, int size, FILE *stream)
+{
+    char *res = __real_fgets(s, size, stream);
+    if (res)
+        draw_stats.file_bytes += strlen(res);
+    return res;
+}
+
 void TxName(u8 *var, int len) {
     const u8 model[] = "EMU_STRING";
     if(len > 12)
@@ -111,8 +145,7 @@ void HID_SetInterval(u8 interval) {
 void HID_Enable() {}
 void HID_Disable() {}
 void HID_Write(s8 *pkt, u8 size) {
-    (void)pkt;
-    (void)size;
+    TRACE_Bytes("HID", (u8 *)pkt, size);
 }
 volatile u8 HID_prevXferComplete;
 void Initialize_ButtonMatrix() {}
@@ -144,7 +177,7 @@ u8 *BOOTLOADER_Read(int idx) {
 }
 
 void UART_Initialize() {}
-u8 UART_Send(u8 *data, u16 len) { (void)data; (void)len; return 0;}
+u8 UART_Send(u8 *data, u16 len) { TRACE_Bytes("UART", data, len); return 0;}
 void UART_Stop() {}
 void UART_SetDataRate(u32 bps) { (void)bps;}
 void UART_SetFormat(int bits, uart_parity parity, uart_stopbits stopbits) {(void) bits; (void) parity; (void) stopbits;}
@@ -180,7 +213,8 @@ void SSER_StartReceive(sser_callback_t isr_callback) { (void)isr_callback;}
 void SSER_Initialize() {}
 void SSER_Stop() {}
 
-void PXX_Enable(u8 *packet) { (void)packet; }
+#define PXX_PKT_BYTES 18
+void PXX_Enable(u8 *packet) { TRACE_Bytes("PXX", packet, PXX_PKT_BYTES); }
 
 void MCU_SerialNumber(u8 *var, int len)
 {
@@ -19,6 +19,9 @@
 #define SUPPORT_MULTI_LANGUAGE 0
 
 #define HAS_LCD_TYPES       (LCDTYPE_ILI9341)
+#ifndef LCD_IMAGE_CACHE_SIZE
+    #define LCD_IMAGE_CACHE_SIZE 20480  // Enough for the stock background
+#endif
 #ifndef LCD_ForceUpdate
 static inline void LCD_ForceUpdate() {}
 #endif
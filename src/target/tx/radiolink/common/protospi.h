@@ -5,6 +5,7 @@
 #include <libopencm3/stm32/spi.h>
 
 u8 PROTOSPI_read3wire();
+void PROTOSPI_write(const u8 *data, int len);
 
 #define PROTOSPI_pin_set(io) gpio_set(io.port, io.pin)
 #define PROTOSPI_pin_clear(io) gpio_clear(io.port, io.pin)
@@ -14,6 +14,7 @@
  */
 #include "common.h"
 #include "music.h"
+#include "extended_audio.h"
 #include "config/model.h"
 #include "config/tx.h"
 #include "telemetry.h"
@@ -27,6 +28,9 @@ static void _get_altitude_str(char *str, s32 value, u8 decimals, char units);
 #if HAS_EXTENDED_TELEMETRY
 #include "telemetry/telem_crsf.c"
 #endif  // HAS_EXTENDED_TELEMETRY
+#if HAS_DATALOG
+#include "telemetry/telem_history.c"
+#endif
 
 #define CAP_DSM   1
 #define CAP_FRSKY 2
@@ -36,9 +40,16 @@ static void _get_altitude_str(char *str, s32 value, u8 decimals, char units);
 struct Telemetry Telemetry;
 static u8 telem_idx = 0;
 static u32 last_updated[TELEM_UPDATE_SIZE] = {0};
+static volatile u32 pending[TELEM_UPDATE_SIZE] = {0};
+// Sources reported since the GUI last looked, double banked so the GUI can
+// take them without blocking the protocol interrupt.  Bit 0 is set from the
+// main loop via 'state_changed' when an alarm or the 'no telemetry' state moves.
+static volatile u32 gui_changes[2][TELEM_UPDATE_SIZE];
+static volatile u8 gui_bank;
+static u8 state_changed;
 static u32 music_time = 0;
 static u32 error_time = 0;
-#define CHECK_DURATION 500
+#define TELEM_ALARM_HYSTERESIS_SHIFT 8
 
 void _get_value_str(char *str, s32 value, u8 decimals, char units)
 {
@@ -287,6 +298,25 @@ s32 TELEMETRY_GetMinValue(int idx)
 void TELEMETRY_SetUpdated(int idx)
 {
     Telemetry.updated[idx/32] |= (1 << idx % 32);
+    pending[idx/32] |= (1 << idx % 32);
+#if HAS_DATALOG
+    history_fresh[idx/32] |= (1 << idx % 32);
+#endif
+    gui_changes[gui_bank][idx/32] |= (1 << idx % 32);
+}
+
+/* Copy the sources updated since the previous call into 'changed'
+ * (TELEM_UPDATE_SIZE long).  Bit 0 means alarm or link state changed. */
+void TELEMETRY_TakeChanges(u32 *changed)
+{
+    unsigned bank = gui_bank;
+    gui_bank = ! bank;
+    for (int i = 0; i < TELEM_UPDATE_SIZE; i++) {
+        changed[i] = gui_changes[bank][i];
+        gui_changes[bank][i] = 0;
+    }
+    changed[0] |= state_changed;
+    state_changed = 0;
 }
 
 int TELEMETRY_Type()
@@ -324,177 +354,218 @@ void TELEMETRY_SetType(int type)
 }
 
 //#define DEBUG_TELEMALARM
-void TELEMETRY_Alarm()
+static void _play_alarm(int idx)
 {
-    if (PROTOCOL_GetTelemetryState() != PROTO_TELEM_ON)
-        return;
-
-    //Update 'updated' state every time we get here
-    u32 current_time = CLOCK_getms();
-    if (current_time >= error_time) {
-        error_time = current_time + TELEM_ERROR_TIME;
-        for(int i = 0; i < TELEM_UPDATE_SIZE; i++) {
-            last_updated[i] = Telemetry.updated[i];
-            Telemetry.updated[i] = 0;
-        }
-    }
-    // don't need to check all the 6 telem-configs at one time, this is not a critical and urgent task
-    // instead, check 1 of them at a time
-    telem_idx = (telem_idx + 1) % TELEM_NUM_ALARMS;
-    struct TelemetryAlarm *alarm = &Model.alarms[telem_idx];
-
-    if (current_time >= alarm->alarm_time) {
-        alarm->alarm_time = current_time + CHECK_DURATION;
-        if (!TELEMETRY_IsUpdated(alarm->src)) {
-            TELEMETRY_ResetAlarm(telem_idx);
-        } else if ((TELEMETRY_GetValue( alarm->src ) - alarm->mute_value <=
-                                        alarm->value) == alarm->above) {
-            if (!alarm->state) {
-                alarm->state++;
-                alarm->limit_threshold_time = current_time + (alarm->threshold * 1000);
 #ifdef DEBUG_TELEMALARM
-                printf("set: 0x%x\n\n", telem_idx);
+    printf("beep: %d\n\n", idx);
 #endif
-            }
-        } else if (alarm->state) {
-            alarm->state = 0;
-            alarm->limit_threshold_time = 0;
-#ifdef DEBUG_TELEMALARM
-            printf("clear: 0x%x\n\n", telem_idx);
-#endif
-        }
-    }
-
-    if (alarm->state == 1 &&
-        current_time >= music_time &&
-        current_time >= alarm->limit_threshold_time) {
-        music_time = current_time + Transmitter.telem_alert_interval*1000;
-        // telem_idx > 2 is exclude first 3 alarms from jump action (interim solution)
-        // <= (9 + type) is limit jump action to only visible telemetry monitor values
-        if (telem_idx > 2 && alarm->src <= (9 + TELEMETRY_Type()))
-            PAGE_ShowTelemetryAlarm();
-#ifdef DEBUG_TELEMALARM
-        printf("beep: %d\n\n", telem_idx);
-#endif
-
 #if HAS_EXTENDED_AUDIO
-        u16 telem_music = MUSIC_GetTelemetryAlarm(MUSIC_TELEMALARM1 + telem_idx);
-        s32 telem_value = TELEMETRY_GetValue(alarm->src);
-        if (TELEMETRY_Type() == TELEM_DEVO) {
-            switch (alarm->src) {
-                case TELEM_DEVO_VOLT1:
-                case TELEM_DEVO_VOLT2:
-                case TELEM_DEVO_VOLT3: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_VOLT,1); break;
-                case TELEM_DEVO_RPM1:
-                case TELEM_DEVO_RPM2: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_RPM,0); break;
-                default: MUSIC_PlayValue(telem_music, telem_value-20,VOICE_UNIT_TEMP,0); break;
-            }
+    struct TelemetryAlarm *alarm = &Model.alarms[idx];
+    AUDIO_SetPriority(AUDIO_PRIO_ALARM);
+    u16 telem_music = MUSIC_GetTelemetryAlarm(MUSIC_TELEMALARM1 + idx);
+    s32 telem_value = TELEMETRY_GetValue(alarm->src);
+    if (TELEMETRY_Type() == TELEM_DEVO) {
+        switch (alarm->src) {
+            case TELEM_DEVO_VOLT1:
+            case TELEM_DEVO_VOLT2:
+            case TELEM_DEVO_VOLT3: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_VOLT,1); break;
+            case TELEM_DEVO_RPM1:
+            case TELEM_DEVO_RPM2: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_RPM,0); break;
+            default: MUSIC_PlayValue(telem_music, telem_value-20,VOICE_UNIT_TEMP,0); break;
         }
-        if (TELEMETRY_Type() == TELEM_DSM) {
-            switch (alarm->src) {
+    }
+    if (TELEMETRY_Type() == TELEM_DSM) {
+        switch (alarm->src) {
 #if HAS_EXTENDED_TELEMETRY
-                case TELEM_DSM_JETCAT_RPM:
-                case TELEM_DSM_ESC_RPM:
+            case TELEM_DSM_JETCAT_RPM:
+            case TELEM_DSM_ESC_RPM:
 #endif
-                case TELEM_DSM_FLOG_RPM1: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_RPM,0); break;
+            case TELEM_DSM_FLOG_RPM1: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_RPM,0); break;
 #if HAS_EXTENDED_TELEMETRY
-                case TELEM_DSM_PBOX_VOLT1:
-                case TELEM_DSM_PBOX_VOLT2:
-                case TELEM_DSM_JETCAT_PACKVOLT:
-                case TELEM_DSM_JETCAT_PUMPVOLT:
-                case TELEM_DSM_RXPCAP_VOLT:
-                case TELEM_DSM_ESC_VOLT1:
-                case TELEM_DSM_ESC_VOLT2:
+            case TELEM_DSM_PBOX_VOLT1:
+            case TELEM_DSM_PBOX_VOLT2:
+            case TELEM_DSM_JETCAT_PACKVOLT:
+            case TELEM_DSM_JETCAT_PUMPVOLT:
+            case TELEM_DSM_RXPCAP_VOLT:
+            case TELEM_DSM_ESC_VOLT1:
+            case TELEM_DSM_ESC_VOLT2:
 #endif
-                case TELEM_DSM_FLOG_VOLT1:
-                case TELEM_DSM_FLOG_VOLT2: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_VOLT,2); break;
+            case TELEM_DSM_FLOG_VOLT1:
+            case TELEM_DSM_FLOG_VOLT2: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_VOLT,2); break;
 #if HAS_EXTENDED_TELEMETRY
-                case TELEM_DSM_JETCAT_TEMPEGT: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_TEMP,0); break;
-                case TELEM_DSM_ESC_TEMP1:
-                case TELEM_DSM_ESC_TEMP2:
+            case TELEM_DSM_JETCAT_TEMPEGT: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_TEMP,0); break;
+            case TELEM_DSM_ESC_TEMP1:
+            case TELEM_DSM_ESC_TEMP2:
 #endif
-                case TELEM_DSM_FLOG_TEMP1: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_TEMP,1); break;
+            case TELEM_DSM_FLOG_TEMP1: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_TEMP,1); break;
 #if HAS_EXTENDED_TELEMETRY
-                case TELEM_DSM_RXPCAP_AMPS:
-                case TELEM_DSM_ESC_AMPS1: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_AMPS,2); break;
-                case TELEM_DSM_FPCAP_AMPS:
-                case TELEM_DSM_ESC_AMPS2:
+            case TELEM_DSM_RXPCAP_AMPS:
+            case TELEM_DSM_ESC_AMPS1: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_AMPS,2); break;
+            case TELEM_DSM_FPCAP_AMPS:
+            case TELEM_DSM_ESC_AMPS2:
 #endif
-                case TELEM_DSM_AMPS1: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_AMPS,1); break;
-                case TELEM_DSM_ALTITUDE:
-                case TELEM_DSM_ALTITUDE_MAX:
-                case TELEM_DSM_VARIO_CLIMBRATE1:
-                case TELEM_DSM_VARIO_CLIMBRATE2:
-                case TELEM_DSM_VARIO_CLIMBRATE3:
-                case TELEM_DSM_VARIO_CLIMBRATE4:
-                case TELEM_DSM_VARIO_CLIMBRATE5:
-                case TELEM_DSM_VARIO_CLIMBRATE6:
-                case TELEM_DSM_VARIO_ALTITUDE: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_ALTITUDE,1); break;
-
-                case TELEM_DSM_GFORCE_X:
-                case TELEM_DSM_GFORCE_Y:
-                case TELEM_DSM_GFORCE_Z:
-                case TELEM_DSM_GFORCE_XMAX:
-                case TELEM_DSM_GFORCE_YMAX:
-                case TELEM_DSM_GFORCE_ZMAX:
-                case TELEM_DSM_GFORCE_ZMIN: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_GFORCE,2); break;
+            case TELEM_DSM_AMPS1: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_AMPS,1); break;
+            case TELEM_DSM_ALTITUDE:
+            case TELEM_DSM_ALTITUDE_MAX:
+            case TELEM_DSM_VARIO_CLIMBRATE1:
+            case TELEM_DSM_VARIO_CLIMBRATE2:
+            case TELEM_DSM_VARIO_CLIMBRATE3:
+            case TELEM_DSM_VARIO_CLIMBRATE4:
+            case TELEM_DSM_VARIO_CLIMBRATE5:
+            case TELEM_DSM_VARIO_CLIMBRATE6:
+            case TELEM_DSM_VARIO_ALTITUDE: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_ALTITUDE,1); break;
+
+            case TELEM_DSM_GFORCE_X:
+            case TELEM_DSM_GFORCE_Y:
+            case TELEM_DSM_GFORCE_Z:
+            case TELEM_DSM_GFORCE_XMAX:
+            case TELEM_DSM_GFORCE_YMAX:
+            case TELEM_DSM_GFORCE_ZMAX:
+            case TELEM_DSM_GFORCE_ZMIN: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_GFORCE,2); break;
 #if HAS_EXTENDED_TELEMETRY
-                case TELEM_DSM_FLOG_RSSI_DBM: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_DB,0); break;
+            case TELEM_DSM_FLOG_RSSI_DBM: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_DB,0); break;
 #endif
-                default: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_NONE,0);
-          }
-        }
+            default: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_NONE,0);
+      }
+    }
 
-        if (TELEMETRY_Type() == TELEM_FRSKY) {
-            switch (alarm->src) {
+    if (TELEMETRY_Type() == TELEM_FRSKY) {
+        switch (alarm->src) {
 #if HAS_EXTENDED_TELEMETRY
-                case TELEM_FRSKY_VOLT3:
-                case TELEM_FRSKY_VOLTA:
-                case TELEM_FRSKY_MIN_CELL:
-                case TELEM_FRSKY_ALL_CELL:
-                case TELEM_FRSKY_CELL1:
-                case TELEM_FRSKY_CELL2:
-                case TELEM_FRSKY_CELL3:
-                case TELEM_FRSKY_CELL4:
-                case TELEM_FRSKY_CELL5:
-                case TELEM_FRSKY_CELL6:
+            case TELEM_FRSKY_VOLT3:
+            case TELEM_FRSKY_VOLTA:
+            case TELEM_FRSKY_MIN_CELL:
+            case TELEM_FRSKY_ALL_CELL:
+            case TELEM_FRSKY_CELL1:
+            case TELEM_FRSKY_CELL2:
+            case TELEM_FRSKY_CELL3:
+            case TELEM_FRSKY_CELL4:
+            case TELEM_FRSKY_CELL5:
+            case TELEM_FRSKY_CELL6:
 #endif
-                case TELEM_FRSKY_VOLT1:
-                case TELEM_FRSKY_VOLT2: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_VOLT,2); break;
+            case TELEM_FRSKY_VOLT1:
+            case TELEM_FRSKY_VOLT2: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_VOLT,2); break;
 #if HAS_EXTENDED_TELEMETRY
-                case TELEM_FRSKY_TEMP1:
-                case TELEM_FRSKY_TEMP2: MUSIC_PlayValue(telem_music, telem_value-20,VOICE_UNIT_TEMP,0); break;
-                case TELEM_FRSKY_RPM: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_RPM,0); break;
-                case TELEM_FRSKY_CURRENT: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_AMPS,2); break;
-                case TELEM_FRSKY_ALTITUDE: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_ALTITUDE,2); break;
+            case TELEM_FRSKY_TEMP1:
+            case TELEM_FRSKY_TEMP2: MUSIC_PlayValue(telem_music, telem_value-20,VOICE_UNIT_TEMP,0); break;
+            case TELEM_FRSKY_RPM: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_RPM,0); break;
+            case TELEM_FRSKY_CURRENT: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_AMPS,2); break;
+            case TELEM_FRSKY_ALTITUDE: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_ALTITUDE,2); break;
 #endif
-                case TELEM_FRSKY_LRSSI:
-                case TELEM_FRSKY_RSSI: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_DB,0); break;
-                default: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_NONE,0);
-            }
+            case TELEM_FRSKY_LRSSI:
+            case TELEM_FRSKY_RSSI: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_DB,0); break;
+            default: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_NONE,0);
         }
+    }
 
 #if HAS_EXTENDED_TELEMETRY
-        if (TELEMETRY_Type() == TELEM_CRSF) {
-            switch (alarm->src) {
-                case TELEM_CRSF_BATT_VOLTAGE:
-                    MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_VOLT,2); break;
-                case TELEM_CRSF_BATT_CURRENT: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_AMPS,2); break;
-                case TELEM_CRSF_GPS_ALTITUDE: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_ALTITUDE,2); break;
-                case TELEM_CRSF_TX_SNR:
-                case TELEM_CRSF_TX_RSSI:
-                case TELEM_CRSF_RX_SNR:
-                case TELEM_CRSF_RX_RSSI1:
-                case TELEM_CRSF_RX_RSSI2: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_DB,0); break;
-                default: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_NONE,0);
-            }
+    if (TELEMETRY_Type() == TELEM_CRSF) {
+        switch (alarm->src) {
+            case TELEM_CRSF_BATT_VOLTAGE:
+                MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_VOLT,2); break;
+            case TELEM_CRSF_BATT_CURRENT: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_AMPS,2); break;
+            case TELEM_CRSF_GPS_ALTITUDE: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_ALTITUDE,2); break;
+            case TELEM_CRSF_TX_SNR:
+            case TELEM_CRSF_TX_RSSI:
+            case TELEM_CRSF_RX_SNR:
+            case TELEM_CRSF_RX_RSSI1:
+            case TELEM_CRSF_RX_RSSI2: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_DB,0); break;
+            default: MUSIC_PlayValue(telem_music, telem_value,VOICE_UNIT_NONE,0);
         }
+    }
 #endif //HAS_EXTENDED_TELEMETRY
+    AUDIO_SetPriority(AUDIO_PRIO_NORMAL);
 
 #else
-        MUSIC_Play(MUSIC_TELEMALARM1 + telem_idx);
+    MUSIC_Play(MUSIC_TELEMALARM1 + idx);
 #endif //HAS_EXTENDED_AUDIO
+}
+
+/* An active alarm must move back past its limit by this much before it is
+ * cleared, so a value hovering at the limit does not toggle the alarm */
+static s32 _alarm_hysteresis(int src)
+{
+    return (TELEMETRY_GetMaxValue(src) - TELEMETRY_GetMinValue(src)) >> TELEM_ALARM_HYSTERESIS_SHIFT;
+}
 
+static void _check_alarm(int idx, u32 current_time)
+{
+    struct TelemetryAlarm *alarm = &Model.alarms[idx];
+    s32 value = TELEMETRY_GetValue(alarm->src) - alarm->mute_value;
+    s32 limit = alarm->value;
+    if (alarm->state) {
+        s32 hyst = _alarm_hysteresis(alarm->src);
+        limit += alarm->above ? hyst : -hyst;
+    }
+    if ((value <= limit) == alarm->above) {
+        if (!alarm->state) {
+            alarm->state++;
+            state_changed = 1;
+            // the threshold acts as a debounce: the value must stay past the
+            // limit for 'threshold' seconds before the alarm sounds
+            alarm->limit_threshold_time = current_time + (alarm->threshold * 1000);
+#ifdef DEBUG_TELEMALARM
+            printf("set: 0x%x\n\n", idx);
+#endif
+        }
+    } else if (alarm->state) {
+        alarm->state = 0;
+        alarm->limit_threshold_time = 0;
+        state_changed = 1;
+#ifdef DEBUG_TELEMALARM
+        printf("clear: 0x%x\n\n", idx);
+#endif
+    }
+}
+
+void TELEMETRY_Alarm()
+{
+    if (PROTOCOL_GetTelemetryState() != PROTO_TELEM_ON)
+        return;
+
+    u32 current_time = CLOCK_getms();
+    if (current_time >= error_time) {
+        error_time = current_time + TELEM_ERROR_TIME;
+        state_changed = 1;
+        for(int i = 0; i < TELEM_UPDATE_SIZE; i++) {
+            last_updated[i] = Telemetry.updated[i];
+            Telemetry.updated[i] = 0;
+        }
+        // Alarms on sources which stopped reporting are reset
+        for (int i = 0; i < TELEM_NUM_ALARMS; i++) {
+            if (Model.alarms[i].src && !TELEMETRY_IsUpdated(Model.alarms[i].src))
+                TELEMETRY_ResetAlarm(i);
+        }
+    }
+
+    // Only evaluate alarms whose source was reported since the last call
+    u32 changed[TELEM_UPDATE_SIZE];
+    for (int i = 0; i < TELEM_UPDATE_SIZE; i++) {
+        // Swap, so that an update from the protocol interrupt isn't lost
+        changed[i] = __atomic_exchange_n(&pending[i], 0, __ATOMIC_RELAXED);
+    }
+    for (int i = 0; i < TELEM_NUM_ALARMS; i++) {
+        int src = Model.alarms[i].src;
+        if (src && ((changed[src/32] >> (src % 32)) & 1))
+            _check_alarm(i, current_time);
+    }
+
+    if (current_time < music_time)
+        return;
+    // Start after the last alarm played so that several active alarms take turns
+    for (int i = 1; i <= TELEM_NUM_ALARMS; i++) {
+        int idx = (telem_idx + i) % TELEM_NUM_ALARMS;
+        struct TelemetryAlarm *alarm = &Model.alarms[idx];
+        if (alarm->state == 1 && current_time >= alarm->limit_threshold_time) {
+            telem_idx = idx;
+            music_time = current_time + Transmitter.telem_alert_interval*1000;
+            // idx > 2 is exclude first 3 alarms from jump action (interim solution)
+            // <= (9 + type) is limit jump action to only visible telemetry monitor values
+            if (idx > 2 && alarm->src <= (9 + TELEMETRY_Type()))
+                PAGE_ShowTelemetryAlarm();
+            _play_alarm(idx);
+            break;
+        }
     }
 }
 
@@ -503,6 +574,7 @@ void TELEMETRY_ResetAlarm(int i)
     struct TelemetryAlarm *alarm = &Model.alarms[i];
     alarm->state = 0;
     alarm->mute_value = 0;
+    state_changed = 1;
 }
 
 void TELEMETRY_ResetValues(void)
@@ -510,6 +582,9 @@ void TELEMETRY_ResetValues(void)
     // Reset cumulative values, altitude ground level, etc.
     // Exact values are protocol depenedent
     PROTOCOL_ResetTelemetry();
+#if HAS_DATALOG
+    TELEMETRY_ResetHistory();
+#endif
     SOUND_SetFrequency(3951, Transmitter.volume * 10);
     SOUND_StartWithoutVibrating(100, NULL);
 }
@@ -521,6 +596,7 @@ void TELEMETRY_MuteAlarm()
         if (alarm->state == 1) {
             alarm->mute_value = TELEMETRY_GetValue(alarm->src) - (alarm->above << 8);
             alarm->state++;
+            state_changed = 1;
         }
     }
 }
@@ -535,3 +611,6 @@ int TELEMETRY_HasAlarm(int src)
 
     return 0;
 }
+
+#define TESTNAME telemetry
+#include <tests.h>
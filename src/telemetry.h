@@ -8,6 +8,15 @@
 #define TELEM_ERROR_TIME 5000
 #define TELEM_NUM_ALARMS 6
 
+// Number of sources which can keep a time series, and samples per tier
+#if HAS_EXTENDED_TELEMETRY
+#define TELEM_HIST_SLOTS 4
+#define TELEM_HIST_DEPTH 16
+#else
+#define TELEM_HIST_SLOTS 2
+#define TELEM_HIST_DEPTH 8
+#endif
+
 
 enum {
     TELEM_CRSF,
@@ -222,6 +231,20 @@ struct Telemetry {
     volatile u32 updated[TELEM_UPDATE_SIZE];
 };
 
+enum {
+    TELEM_HIST_100MS = 0,
+    TELEM_HIST_1SEC,
+    TELEM_HIST_10SEC,
+    TELEM_HIST_TIERS,
+};
+
+struct TelemetryStats {
+    s32 min;
+    s32 max;
+    s32 avg;
+    u32 count;
+};
+
 enum {
     PROTO_TELEM_UNSUPPORTED = 0,
     PROTO_TELEM_OFF = 1,
@@ -350,7 +373,6 @@ struct TelemetryAlarm {
     u8 state;  // 3 states: 0 = off, 1 = on, 2 = mute
     s32 value;
     s32 mute_value;
-    u32 alarm_time;
     u32 limit_threshold_time;
 };
 
@@ -368,9 +390,16 @@ void TELEMETRY_ResetAlarm(int i);
 void TELEMETRY_MuteAlarm();
 int TELEMETRY_HasAlarm(int src);
 u32 TELEMETRY_IsUpdated(int val);
+void TELEMETRY_TakeChanges(u32 *changed);
 void TELEMETRY_SetUpdated(int telem);
 int TELEMETRY_Type();
 void TELEMETRY_SetType(int type);
 int TELEMETRY_GetNumTelemSrc();
 void TELEMETRY_ResetValues();
+int TELEMETRY_HistorySubscribe(int src);
+void TELEMETRY_HistoryUnsubscribe(int src);
+void TELEMETRY_UpdateHistory();
+void TELEMETRY_ResetHistory();
+int TELEMETRY_GetStats(int src, struct TelemetryStats *stats);
+int TELEMETRY_GetHistory(int src, int tier, s32 *samples, int count);
 #endif
@@ -0,0 +1,192 @@
+/*
+ This project is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Deviation is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* In-RAM time series for a few subscribed telemetry sources, used by the
+ * datalog.  Each source keeps TELEM_HIST_TIERS rings of TELEM_HIST_DEPTH
+ * samples.  Tier 0 takes at most one sample every TELEM_HIST_PERIOD ms, and
+ * only when the protocol reported a new value since the previous one.  Each
+ * following tier stores the average of TELEM_HIST_DECIMATE samples of the
+ * previous one (100ms / 1s / 10s).  Min/max/average since the last reset
+ * are kept as running values so querying them never walks the rings.
+ * Subscriptions are counted, a slot is freed when its last user unsubscribes.
+ */
+#define TELEM_HIST_PERIOD   100
+#define TELEM_HIST_DECIMATE 10
+
+struct telem_tier {
+    s32 sample[TELEM_HIST_DEPTH];
+    s32 acc;       // sum of samples not yet folded into the next tier
+    u8 pos;        // next write position
+    u8 count;      // number of valid samples
+    u8 acc_count;
+};
+
+struct telem_history {
+    u8 src;        // 0 = free slot
+    u8 users;      // number of subscriptions
+    s32 min;
+    s32 max;
+    s32 avg;       // the exact mean is avg + rem / count
+    s32 rem;
+    u32 count;
+    struct telem_tier tier[TELEM_HIST_TIERS];
+};
+
+static struct telem_history history[TELEM_HIST_SLOTS];
+static u32 history_time;
+// Sources reported since the last sample, set from TELEMETRY_SetUpdated()
+static volatile u32 history_fresh[TELEM_UPDATE_SIZE];
+
+static struct telem_history *_find_history(int src)
+{
+    if (!src)
+        return NULL;
+    for (int i = 0; i < TELEM_HIST_SLOTS; i++) {
+        if (history[i].src == src)
+            return &history[i];
+    }
+    return NULL;
+}
+
+static void _clear_history(struct telem_history *h)
+{
+    u8 src = h->src, users = h->users;
+    memset(h, 0, sizeof(*h));
+    h->src = src;
+    h->users = users;
+}
+
+static void _push_sample(struct telem_history *h, int tier, s32 value)
+{
+    struct telem_tier *t = &h->tier[tier];
+    t->sample[t->pos] = value;
+    t->pos = (t->pos + 1) % TELEM_HIST_DEPTH;
+    if (t->count < TELEM_HIST_DEPTH)
+        t->count++;
+    if (tier + 1 == TELEM_HIST_TIERS)
+        return;
+    t->acc += value;
+    if (++t->acc_count == TELEM_HIST_DECIMATE) {
+        _push_sample(h, tier + 1, t->acc / TELEM_HIST_DECIMATE);
+        t->acc = 0;
+        t->acc_count = 0;
+    }
+}
+
+static void _record_value(struct telem_history *h, s32 value)
+{
+    if (!h->count || value < h->min)
+        h->min = value;
+    if (!h->count || value > h->max)
+        h->max = value;
+    // Keep the mean without a 64-bit sum: fold whole multiples of count
+    // out of the remainder, rounding towards -inf so rem stays positive
+    h->count++;
+    h->rem += value - h->avg;
+    s32 q = h->rem / (s32)h->count;
+    h->rem -= q * (s32)h->count;
+    if (h->rem < 0) {
+        q--;
+        h->rem += h->count;
+    }
+    h->avg += q;
+    _push_sample(h, 0, value);
+}
+
+int TELEMETRY_HistorySubscribe(int src)
+{
+    if (!src)
+        return -1;
+    int free_slot = -1;
+    for (int i = 0; i < TELEM_HIST_SLOTS; i++) {
+        if (history[i].src == src) {
+            history[i].users++;
+            return i;
+        }
+        if (!history[i].src && free_slot < 0)
+            free_slot = i;
+    }
+    if (free_slot >= 0) {
+        memset(&history[free_slot], 0, sizeof(history[free_slot]));
+        history[free_slot].src = src;
+        history[free_slot].users = 1;
+    }
+    return free_slot;
+}
+
+void TELEMETRY_HistoryUnsubscribe(int src)
+{
+    struct telem_history *h = _find_history(src);
+    if (h && !--h->users)
+        h->src = 0;
+}
+
+void TELEMETRY_ResetHistory()
+{
+    for (int i = 0; i < TELEM_HIST_SLOTS; i++)
+        _clear_history(&history[i]);
+}
+
+void TELEMETRY_UpdateHistory()
+{
+    if (PROTOCOL_GetTelemetryState() != PROTO_TELEM_ON)
+        return;
+    u32 current_time = CLOCK_getms();
+    if (current_time < history_time)
+        return;
+    // Don't try to catch up after a long stall, just restart the sampling clock
+    if (current_time - history_time >= TELEM_HIST_PERIOD)
+        history_time = current_time;
+    history_time += TELEM_HIST_PERIOD;
+
+    u32 fresh[TELEM_UPDATE_SIZE];
+    for (int i = 0; i < TELEM_UPDATE_SIZE; i++)
+        fresh[i] = __atomic_exchange_n(&history_fresh[i], 0, __ATOMIC_RELAXED);
+    for (int i = 0; i < TELEM_HIST_SLOTS; i++) {
+        struct telem_history *h = &history[i];
+        if (!h->src || !((fresh[h->src / 32] >> (h->src % 32)) & 1))
+            continue;
+        _record_value(h, TELEMETRY_GetValue(h->src));
+    }
+}
+
+int TELEMETRY_GetStats(int src, struct TelemetryStats *stats)
+{
+    struct telem_history *h = _find_history(src);
+    if (!h || !h->count)
+        return 0;
+    stats->min = h->min;
+    stats->max = h->max;
+    stats->avg = h->avg;
+    stats->count = h->count;
+    return 1;
+}
+
+int TELEMETRY_GetHistory(int src, int tier, s32 *samples, int count)
+{
+    struct telem_history *h = _find_history(src);
+    if (!h || tier < 0 || tier >= TELEM_HIST_TIERS)
+        return 0;
+    struct telem_tier *t = &h->tier[tier];
+    if (count > t->count)
+        count = t->count;
+    // newest sample first
+    int pos = t->pos;
+    for (int i = 0; i < count; i++) {
+        pos = (pos + TELEM_HIST_DEPTH - 1) % TELEM_HIST_DEPTH;
+        samples[i] = t->sample[pos];
+    }
+    return count;
+}
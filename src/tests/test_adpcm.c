@@ -0,0 +1,43 @@
+#include "CuTest.h"
+
+static s16 test_pcm[64];
+static unsigned test_count;
+
+static void test_push(s16 sample)
+{
+    if (test_count < sizeof(test_pcm) / sizeof(test_pcm[0]))
+        test_pcm[test_count] = sample;
+    test_count++;
+}
+
+static void AssertDecode(CuTest *t, const u8 *block, unsigned len, const s16 *pcm, unsigned count)
+{
+    test_count = 0;
+    CuAssertIntEquals(t, count, ADPCM_DecodeBlock(block, len, test_push));
+    CuAssertIntEquals(t, count, test_count);
+    for (unsigned i = 0; i < count; i++)
+        CuAssertIntEquals(t, pcm[i], test_pcm[i]);
+}
+
+void TestAdpcmDecode(CuTest *t)
+{
+    // Reference PCM from the IMA-ADPCM reference decoder
+    const u8 block[] = {
+        0x18, 0xfc, 0x0a, 0x00, 0x77, 0x77, 0x70, 0x07,
+        0x12, 0x34, 0xff, 0xf8, 0x8f, 0x9a, 0xbc, 0x00,
+    };
+    const s16 pcm[] = {
+        -1000, -966, -890, -725, -370, -319, 375, 1867, 2080, 3050,
+        3578, 5020, 6378, 3734, -1936, -2746, -13796, -32768, -32768, -32768,
+        -32768, -32768, -32768, -29970, -27427,
+    };
+    AssertDecode(t, block, sizeof(block), pcm, sizeof(pcm) / sizeof(pcm[0]));
+
+    // Clipped at the top of the range
+    const u8 block_high[] = {0x00, 0x7d, 0x3c, 0x00, 0x77, 0x07, 0xf0, 0x88};
+    const s16 pcm_high[] = {32000, 32767, 32767, 32767, 32767, 32767, -1920, -6015, -9739};
+    AssertDecode(t, block_high, sizeof(block_high), pcm_high, sizeof(pcm_high) / sizeof(pcm_high[0]));
+
+    // A block without a complete header holds no samples
+    AssertDecode(t, block, 3, pcm, 0);
+}
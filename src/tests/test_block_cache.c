@@ -0,0 +1,88 @@
+#include "CuTest.h"
+
+#define TEST_DISK_BLOCKS 64
+
+static u8 test_disk[TEST_DISK_BLOCKS * BLOCK_CACHE_BLOCK_SIZE];
+static unsigned test_reads;
+
+static int test_read(u32 block, unsigned count, u8 *buf)
+{
+    if (block + count > TEST_DISK_BLOCKS)
+        return 1;
+    test_reads++;
+    memcpy(buf, test_disk + block * BLOCK_CACHE_BLOCK_SIZE, count * BLOCK_CACHE_BLOCK_SIZE);
+    return 0;
+}
+
+static void test_cache_reset()
+{
+    for (unsigned i = 0; i < sizeof(test_disk); i++)
+        test_disk[i] = i * 7 + (i >> 8);
+    BLOCKCACHE_Flush();
+    memset(&stats, 0, sizeof(stats));
+    test_reads = 0;
+}
+
+static void AssertCachedRead(CuTest *t, u32 addr, u32 len)
+{
+    u8 buf[3 * BLOCK_CACHE_BLOCK_SIZE];
+    int ret = BLOCKCACHE_Read(0, test_read, 0, addr, len, buf);
+    CuAssertIntEquals(t, 0, ret);
+    CuAssertTrue(t, memcmp(buf, test_disk + addr, len) == 0);
+}
+
+void TestBlockCacheRead(CuTest *t)
+{
+    test_cache_reset();
+    // Unaligned read across a block boundary, then again from the cache
+    AssertCachedRead(t, BLOCK_CACHE_BLOCK_SIZE - 10, 20);
+    unsigned reads = test_reads;
+    AssertCachedRead(t, BLOCK_CACHE_BLOCK_SIZE - 10, 20);
+    CuAssertIntEquals(t, reads, test_reads);
+    CuAssertIntEquals(t, 2, stats.hits);
+
+    // Large aligned reads go straight to the device
+    AssertCachedRead(t, 8 * BLOCK_CACHE_BLOCK_SIZE, 2 * BLOCK_CACHE_BLOCK_SIZE + 5);
+    CuAssertIntEquals(t, 2, stats.bypass);
+
+    // Reads past the end of the device fail
+    u8 buf[4];
+    CuAssertTrue(t, BLOCKCACHE_Read(0, test_read, TEST_DISK_BLOCKS, 0, sizeof(buf), buf) != 0);
+
+    // Lines are returned up to and including the '\n'
+    memcpy(test_disk + BLOCK_CACHE_BLOCK_SIZE * 3 - 4, "ab\ncd\n", 6);
+    BLOCKCACHE_Invalidate(0, 2, 2);
+    char line[10];
+    CuAssertIntEquals(t, 3, BLOCKCACHE_ReadStopCR(0, test_read, 0, BLOCK_CACHE_BLOCK_SIZE * 3 - 4, sizeof(line), (u8 *)line));
+    CuAssertIntEquals(t, 3, BLOCKCACHE_ReadStopCR(0, test_read, 0, BLOCK_CACHE_BLOCK_SIZE * 3 - 1, sizeof(line), (u8 *)line));
+    CuAssertTrue(t, memcmp(line, "cd\n", 3) == 0);
+}
+
+void TestBlockCacheReplacement(CuTest *t)
+{
+    test_cache_reset();
+    // Sequential misses read ahead
+    for (int i = 0; i < 4; i++)
+        AssertCachedRead(t, i * BLOCK_CACHE_BLOCK_SIZE, 1);
+    CuAssertTrue(t, stats.readahead > 0);
+    CuAssertTrue(t, test_reads < 4);
+
+    // A block that is missed again after it left the FIFO is kept in the LRU part
+    test_cache_reset();
+    AssertCachedRead(t, 40 * BLOCK_CACHE_BLOCK_SIZE, 1);
+    for (int i = 0; i < BLOCK_CACHE_BLOCKS; i++)
+        AssertCachedRead(t, (i * 2) * BLOCK_CACHE_BLOCK_SIZE, 1);
+    AssertCachedRead(t, 40 * BLOCK_CACHE_BLOCK_SIZE, 1);
+    // A scan over many blocks must not evict it
+    for (int i = 0; i < 2 * BLOCK_CACHE_BLOCKS; i++)
+        AssertCachedRead(t, (i * 2 + 1) * BLOCK_CACHE_BLOCK_SIZE, 1);
+    unsigned reads = test_reads;
+    AssertCachedRead(t, 40 * BLOCK_CACHE_BLOCK_SIZE, 1);
+    CuAssertIntEquals(t, reads, test_reads);
+
+    // Writes must invalidate
+    test_disk[40 * BLOCK_CACHE_BLOCK_SIZE] ^= 0xff;
+    BLOCKCACHE_Invalidate(0, 40, 1);
+    AssertCachedRead(t, 40 * BLOCK_CACHE_BLOCK_SIZE, 1);
+    CuAssertIntEquals(t, reads + 1, test_reads);
+}
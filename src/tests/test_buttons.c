@@ -1,3 +1,4 @@
+#include "CuTest.h"
 
 //Accessor to reset static variable
 u8 TEST_Button_InterruptLongPress()
@@ -6,3 +7,136 @@ u8 TEST_Button_InterruptLongPress()
    interrupt_longpress = 0;
    return old;
 }
+
+static unsigned test_order[4];
+static unsigned test_calls;
+
+static unsigned test_button_cb(u32 button, unsigned flags, void *data)
+{
+    (void)button;
+    (void)flags;
+    test_order[test_calls++ % 4] = (unsigned)(long)data;
+    return (long)data == 3;
+}
+
+void TestButtonDispatch(CuTest *t)
+{
+    buttonAction_t *saved_actions[MAX_BUTTON_ACTIONS];
+    u16 saved_subscribers[32];
+    buttonAction_t *saved_pressed = buttonPressed;
+    buttonAction_t a1, a2, a3, a4;
+
+    memcpy(saved_actions, actions, sizeof(actions));
+    memcpy(saved_subscribers, subscribers, sizeof(subscribers));
+    memset(actions, 0, sizeof(actions));
+    memset(subscribers, 0, sizeof(subscribers));
+
+    BUTTON_RegisterCallback(&a1, 0x03, BUTTON_PRESS, test_button_cb, (void *)1);
+    BUTTON_RegisterCallback(&a2, 0x02, BUTTON_PRESS | BUTTON_RELEASE, test_button_cb, (void *)2);
+    BUTTON_RegisterCallback(&a3, 0x06, BUTTON_PRESS | BUTTON_RELEASE | BUTTON_PRIORITY, test_button_cb, (void *)3);
+    BUTTON_RegisterCallback(&a4, 0x08, BUTTON_PRESS, test_button_cb, (void *)4);
+
+    // Only the subscribers of the pressed button are called, in order
+    test_calls = 0;
+    exec_callbacks(0x01, BUTTON_PRESS);
+    CuAssertIntEquals(t, 1, test_calls);
+    CuAssertIntEquals(t, 1, test_order[0]);
+
+    // The priority action accepts the press and stops the dispatch
+    test_calls = 0;
+    exec_callbacks(0x02, BUTTON_PRESS);
+    CuAssertIntEquals(t, 1, test_calls);
+    CuAssertIntEquals(t, 3, test_order[0]);
+
+    // Only the action that accepted the press sees the release
+    test_calls = 0;
+    exec_callbacks(0x02, BUTTON_RELEASE);
+    CuAssertIntEquals(t, 1, test_calls);
+    CuAssertIntEquals(t, 3, test_order[0]);
+
+    // Once unregistered, the press goes to the others in registration order
+    BUTTON_UnregisterCallback(&a3);
+    BUTTON_UnregisterCallback(&a3);
+    test_calls = 0;
+    exec_callbacks(0x02, BUTTON_PRESS);
+    CuAssertIntEquals(t, 2, test_calls);
+    CuAssertIntEquals(t, 1, test_order[0]);
+    CuAssertIntEquals(t, 2, test_order[1]);
+
+    // Re-registering moves the action to the end
+    BUTTON_RegisterCallback(&a1, 0x03, BUTTON_PRESS, test_button_cb, (void *)1);
+    test_calls = 0;
+    exec_callbacks(0x02, BUTTON_PRESS);
+    CuAssertIntEquals(t, 2, test_order[0]);
+    CuAssertIntEquals(t, 1, test_order[1]);
+
+    BUTTON_UnregisterCallback(&a1);
+    BUTTON_UnregisterCallback(&a2);
+    BUTTON_UnregisterCallback(&a4);
+    for (int i = 0; i < 32; i++)
+        CuAssertIntEquals(t, 0, subscribers[i]);
+
+    memcpy(actions, saved_actions, sizeof(actions));
+    memcpy(subscribers, saved_subscribers, sizeof(subscribers));
+    buttonPressed = saved_pressed;
+}
+
+static unsigned test_pop_event(u32 *buttons, u32 *ms)
+{
+    if (queue_tail == queue_head)
+        return 0;
+    *buttons = queue[queue_tail].buttons;
+    *ms = queue[queue_tail].ms;
+    queue_tail = (queue_tail + 1) % BUTTON_QUEUE_SIZE;
+    return 1;
+}
+
+void TestButtonDebounce(CuTest *t)
+{
+    u32 buttons, ms;
+    u32 saved_debounced = debounced;
+    u8 saved_integrator[32];
+    u32 saved_integrating = integrating;
+    memcpy(saved_integrator, integrator, sizeof(integrator));
+    memset(integrator, 0, sizeof(integrator));
+    integrating = 0;
+    debounced = 0;
+    queue_tail = queue_head;
+
+    // A bouncing contact is ignored until it settles
+    u32 samples[] = {1, 0, 1, 0, 1, 1, 1, 1};
+    for (unsigned i = 0; i < sizeof(samples) / sizeof(samples[0]); i++)
+        BUTTON_Sample(samples[i] | 0x04, 100 + i);
+    CuAssertIntEquals(t, 1, test_pop_event(&buttons, &ms));
+    CuAssertIntEquals(t, 0x04, buttons);
+    CuAssertIntEquals(t, 100 + BUTTON_DEBOUNCE_SAMPLES - 1, ms);
+    CuAssertIntEquals(t, 1, test_pop_event(&buttons, &ms));
+    CuAssertIntEquals(t, 0x05, buttons);
+    CuAssertIntEquals(t, 107, ms);
+    CuAssertIntEquals(t, 0, test_pop_event(&buttons, &ms));
+
+    // A short glitch does not release the button
+    BUTTON_Sample(0x04, 200);
+    BUTTON_Sample(0x05, 202);
+    CuAssertIntEquals(t, 0, test_pop_event(&buttons, &ms));
+
+    // Both buttons are released once their counters run down
+    for (int i = 0; i < BUTTON_DEBOUNCE_SAMPLES; i++)
+        BUTTON_Sample(0, 300 + i);
+    CuAssertIntEquals(t, 1, test_pop_event(&buttons, &ms));
+    CuAssertIntEquals(t, 0, buttons);
+    CuAssertIntEquals(t, 0, integrating);
+
+    // When the queue is full, the latest state is still available
+    for (int i = 0; i < 2 * BUTTON_QUEUE_SIZE; i++) {
+        for (int j = 0; j < BUTTON_DEBOUNCE_SAMPLES; j++)
+            BUTTON_Sample((i & 1) ? 0 : 0x02, 400 + i * 10 + j);
+    }
+    CuAssertIntEquals(t, BUTTON_QUEUE_SIZE - 1, (queue_head - queue_tail + BUTTON_QUEUE_SIZE) % BUTTON_QUEUE_SIZE);
+    CuAssertIntEquals(t, 0, debounced);
+
+    queue_tail = queue_head;
+    memcpy(integrator, saved_integrator, sizeof(integrator));
+    integrating = saved_integrating;
+    debounced = saved_debounced;
+}
@@ -0,0 +1,79 @@
+#include "CuTest.h"
+
+static s32 test_divide_calibrate(s32 value, s32 min, s32 max, s32 zero)
+{
+    max = (max - zero) * 99 / 100;
+    min = (min - zero) * 99 / 100;
+    if (value >= zero)
+        value = (value - zero) * CHAN_MAX_VALUE / max;
+    else
+        value = (value - zero) * CHAN_MIN_VALUE / min;
+    if (value > CHAN_MAX_VALUE)
+        value = CHAN_MAX_VALUE;
+    if (value < CHAN_MIN_VALUE)
+        value = CHAN_MIN_VALUE;
+    return value;
+}
+
+void TestDspCalibrate(CuTest *t)
+{
+    struct dsp_calibration cal;
+    DSP_SetCalibration(&cal, 300, 3800, 2100);
+    for (s32 raw = 0; raw < 4096; raw += 7) {
+        s32 diff = DSP_Calibrate(&cal, raw) - test_divide_calibrate(raw, 300, 3800, 2100);
+        CuAssertTrue(t, diff >= -1 && diff <= 1);
+    }
+    CuAssertIntEquals(t, 0, DSP_Calibrate(&cal, 2100));
+    CuAssertIntEquals(t, CHAN_MAX_VALUE, DSP_Calibrate(&cal, 3800));
+    CuAssertIntEquals(t, CHAN_MIN_VALUE, DSP_Calibrate(&cal, 300));
+
+    // Without a zero, the center is between min and max
+    DSP_SetCalibration(&cal, 1000, 3000, 0);
+    CuAssertIntEquals(t, 0, DSP_Calibrate(&cal, 2000));
+}
+
+void TestDspFilters(CuTest *t)
+{
+    struct dsp_config cfg = {DSP_FILTER_MEDIAN, 0, 0, 0};
+    struct dsp_state st;
+    memset(&st, 0, sizeof(st));
+
+    // Single sample spikes are dropped
+    DSP_Process(&cfg, &st, 100);
+    DSP_Process(&cfg, &st, 100);
+    CuAssertIntEquals(t, 100, DSP_Process(&cfg, &st, 5000));
+    CuAssertIntEquals(t, 100, DSP_Process(&cfg, &st, 100));
+    DSP_Process(&cfg, &st, 2000);
+    CuAssertIntEquals(t, 2000, DSP_Process(&cfg, &st, 2000));
+
+    // The IIR moves half of the way each frame, and settles
+    cfg.filter = DSP_FILTER_IIR;
+    cfg.smoothing = 1;
+    memset(&st, 0, sizeof(st));
+    DSP_Process(&cfg, &st, 0);
+    CuAssertIntEquals(t, 500, DSP_Process(&cfg, &st, 1000));
+    CuAssertIntEquals(t, 750, DSP_Process(&cfg, &st, 1000));
+    for (int i = 0; i < 20; i++)
+        DSP_Process(&cfg, &st, 1000);
+    CuAssertIntEquals(t, 1000, st.out);
+
+    // Jitter around a resting stick is held, a slow move goes through
+    cfg.filter = DSP_FILTER_NONE;
+    cfg.deadband = 2;  // 40
+    memset(&st, 0, sizeof(st));
+    DSP_Process(&cfg, &st, 0);
+    CuAssertIntEquals(t, 0, DSP_Process(&cfg, &st, 30));
+    CuAssertIntEquals(t, 0, DSP_Process(&cfg, &st, -30));
+    CuAssertIntEquals(t, 50, DSP_Process(&cfg, &st, 50));
+    CuAssertIntEquals(t, 60, DSP_Process(&cfg, &st, 60));
+    CuAssertIntEquals(t, 70, DSP_Process(&cfg, &st, 70));
+    CuAssertIntEquals(t, 70, DSP_Process(&cfg, &st, 60));
+    CuAssertIntEquals(t, 70, DSP_Process(&cfg, &st, 80));
+
+    // Slew limit
+    cfg.deadband = 0;
+    cfg.slew = 10;  // 200 per frame
+    CuAssertIntEquals(t, 270, DSP_Process(&cfg, &st, 5000));
+    CuAssertIntEquals(t, 70, DSP_Process(&cfg, &st, -5000));
+    CuAssertIntEquals(t, 0, DSP_Process(&cfg, &st, 0));
+}
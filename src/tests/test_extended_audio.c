@@ -0,0 +1,98 @@
+#include "CuTest.h"
+
+static struct VoiceMap saved_voice_map[MAX_VOICEMAP_ENTRIES];
+
+static void test_queue_setup()
+{
+    memcpy(saved_voice_map, voice_map, sizeof(voice_map));
+    for (int i = 0; i < 40; i++)
+        voice_map[i].duration = 500;
+    AUDIO_ClearQueue();
+    queue_head = 3;  // exercise the wrap around
+    AUDIO_SetPriority(AUDIO_PRIO_NORMAL);
+}
+
+static void test_queue_teardown()
+{
+    AUDIO_ClearQueue();
+    AUDIO_SetPriority(AUDIO_PRIO_NORMAL);
+    memcpy(voice_map, saved_voice_map, sizeof(voice_map));
+}
+
+// The leading mp3 of the next announcement to be spoken, or 0
+static u16 test_next()
+{
+    if (!_next_announcement())
+        return 0;
+    return current.clip[0];
+}
+
+void TestAudioQueueCoalesce(CuTest *t)
+{
+    test_queue_setup();
+    CuAssertIntEquals(t, 1, AUDIO_AddQueue(5));
+    CuAssertIntEquals(t, 1, AUDIO_AppendQueue(30));
+    CuAssertIntEquals(t, 1, AUDIO_AddQueue(6));
+    // A new announcement of the same source replaces the pending one
+    CuAssertIntEquals(t, 1, AUDIO_AddQueue(5));
+    CuAssertIntEquals(t, 1, AUDIO_AppendQueue(31));
+    CuAssertIntEquals(t, 2, queue_count);
+    CuAssertIntEquals(t, 6, test_next());
+    CuAssertIntEquals(t, 5, test_next());
+    CuAssertIntEquals(t, 2, current.num_clips);
+    CuAssertIntEquals(t, 31, current.clip[1]);
+    CuAssertIntEquals(t, 0, test_next());
+
+    // Announcements are limited to AUDIO_MAX_CLIPS, and mp3s need a length
+    AUDIO_AddQueue(7);
+    for (int i = 1; i < AUDIO_MAX_CLIPS; i++)
+        CuAssertIntEquals(t, 1, AUDIO_AppendQueue(20 + i));
+    CuAssertIntEquals(t, 0, AUDIO_AppendQueue(20));
+    voice_map[8].duration = 0;
+    CuAssertIntEquals(t, 0, AUDIO_AddQueue(8));
+    CuAssertIntEquals(t, 1, queue_count);
+    test_queue_teardown();
+}
+
+void TestAudioQueueFull(CuTest *t)
+{
+    test_queue_setup();
+    for (int i = 0; i < AUDIO_QUEUE_LENGTH; i++)
+        CuAssertIntEquals(t, 1, AUDIO_AddQueue(1 + i));
+    // A full queue drops its oldest announcement
+    CuAssertIntEquals(t, 1, AUDIO_AddQueue(20));
+    CuAssertIntEquals(t, AUDIO_QUEUE_LENGTH, queue_count);
+    CuAssertIntEquals(t, 2, _queue_entry(0)->clip[0]);
+
+    // Alarms push out normal announcements, but not the other way around
+    AUDIO_SetPriority(AUDIO_PRIO_ALARM);
+    for (int i = 0; i < AUDIO_QUEUE_LENGTH; i++)
+        CuAssertIntEquals(t, 1, AUDIO_AddQueue(21 + i));
+    AUDIO_SetPriority(AUDIO_PRIO_NORMAL);
+    CuAssertIntEquals(t, 0, AUDIO_AddQueue(1));
+    AUDIO_SetPriority(AUDIO_PRIO_ALARM);
+    CuAssertIntEquals(t, 1, AUDIO_AddQueue(30));
+    CuAssertIntEquals(t, 22, test_next());
+
+    AUDIO_ClearQueue();
+    CuAssertIntEquals(t, 0, AUDIO_Busy());
+    CuAssertIntEquals(t, 0, test_next());
+    test_queue_teardown();
+}
+
+void TestAudioQueuePriority(CuTest *t)
+{
+    test_queue_setup();
+    AUDIO_AddQueue(1);
+    AUDIO_AddQueue(2);
+    AUDIO_SetPriority(AUDIO_PRIO_ALARM);
+    AUDIO_AddQueue(3);
+    AUDIO_AddQueue(4);
+    AUDIO_SetPriority(AUDIO_PRIO_NORMAL);
+    AUDIO_AddQueue(5);
+    // Alarms first, then the rest, each in the order they were queued
+    const u16 order[] = {3, 4, 1, 2, 5, 0};
+    for (unsigned i = 0; i < sizeof(order) / sizeof(order[0]); i++)
+        CuAssertIntEquals(t, order[i], test_next());
+    test_queue_teardown();
+}
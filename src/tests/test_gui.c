@@ -1,4 +1,5 @@
 #include "CuTest.h"
+#include "target/tx/other/test/emu.h"
 
 extern void AssertScreenshot(CuTest* t, const char* filename);
 extern u8 FONT_GetFromString(const char *);
@@ -23,3 +24,67 @@ void TestLabel(CuTest* t)
     GUI_DrawObject(&label);
     AssertScreenshot(t, "label");
 }
+
+static s16 graph_points[5];
+
+static s32 graph_curve_cb(s32 xval, void *data)
+{
+    (void)data;
+    int seg = (xval + 100) / 50;
+    if (seg > 3)
+        seg = 3;
+    s32 x0 = -100 + seg * 50;
+    return graph_points[seg] + (graph_points[seg + 1] - graph_points[seg]) * (xval - x0) / 50;
+}
+
+static u8 graph_point_cb(s16 *x, s16 *y, u8 pos, void *data)
+{
+    (void)data;
+    if (pos >= 5)
+        return 0;
+    *x = -100 + pos * 50;
+    *y = graph_points[pos];
+    return 1;
+}
+
+void TestXYGraphPartialRedraw(CuTest* t)
+{
+    static u8 expected[IMAGE_X * IMAGE_Y * 3];
+    const s16 start[5] = {-100, -50, 0, 50, 100};
+    struct disp_xygraph colors = Display.xygraph;
+    Display.xygraph = (struct disp_xygraph){0x0000, 0xffe0, 0x4208, 0xffff, 0xf800, 0x07e0};
+    guiXYGraph_t graph;
+    // keep the graph off whatever earlier tests left in the object list
+    struct guiObject *head = objHEAD;
+    objHEAD = NULL;
+
+    LCD_Clear(0);
+    memcpy(graph_points, start, sizeof(graph_points));
+    GUI_CreateXYGraph(&graph, 20, 20, 150, 150, -100, -100, 100, 100, 25, 25,
+        graph_curve_cb, graph_point_cb, NULL, NULL);
+    GUI_DrawObject((guiObject_t *)&graph);
+
+    // Nothing changed, so nothing inside the graph may be repainted
+    LCD_DrawPixelXY(25, 25, 0x001f);
+    memcpy(expected, gui.image, sizeof(expected));
+    GUI_DrawObject((guiObject_t *)&graph);
+    CuAssertTrue(t, memcmp(expected, gui.image, sizeof(expected)) == 0);
+
+    // Moving points must give the same picture as drawing from scratch
+    graph_points[3] = -80;
+    graph_points[4] = 20;
+    GUI_DrawObject((guiObject_t *)&graph);
+    graph_points[1] = -40;
+    GUI_DrawObject((guiObject_t *)&graph);
+    LCD_DrawPixelXY(25, 25, 0);
+    memcpy(expected, gui.image, sizeof(expected));
+
+    _GUI_XYGraphInvalidate(0, 0, LCD_WIDTH, LCD_HEIGHT);
+    LCD_Clear(0);
+    GUI_DrawObject((guiObject_t *)&graph);
+    CuAssertTrue(t, memcmp(expected, gui.image, sizeof(expected)) == 0);
+
+    GUI_RemoveObj((guiObject_t *)&graph);
+    objHEAD = head;
+    Display.xygraph = colors;
+}
@@ -0,0 +1,71 @@
+#include "CuTest.h"
+
+static char test_ini_calls[512];
+
+static int test_ini_handler(void* user, const char* section, const char* name, const char* value)
+{
+    (void)user;
+    sprintf(test_ini_calls + strlen(test_ini_calls), "%s|%s|%s\n", section, name, value);
+    return strcmp(name, "bad") != 0;
+}
+
+static int test_ini_parse(const char* text, unsigned len)
+{
+    FILE* fh = tmpfile();
+    fwrite(text, 1, len, fh);
+    rewind(fh);
+    test_ini_calls[0] = '\0';
+    int ret = ini_parse_file(fh, test_ini_handler, NULL);
+    fclose(fh);
+    return ret;
+}
+
+void TestIniParse(CuTest *t)
+{
+    const char text[] =
+        "\xEF\xBB\xBFname=top\r\n"
+        "; comment\n"
+        "  # comment\n"
+        "\n"
+        "[ sec ]  ; section comment\n"
+        "  key  =  some value  ; comment\n"
+        "a:b=c\n"
+        "url=x;y\n"
+        "k2 : v2\n"
+        "empty=\n"
+        "last=1";
+    CuAssertIntEquals(t, 0, test_ini_parse(text, sizeof(text) - 1));
+    CuAssertStrEquals(t,
+        "|name|top\n"
+        " sec |key|some value\n"
+        " sec |a:b|c\n"
+        " sec |url|x;y\n"
+        " sec |k2|v2\n"
+        " sec |empty|\n"
+        " sec |last|1\n", test_ini_calls);
+
+    // Errors report the first bad line, but parsing goes on
+    const char errors[] = "[sec\nnovalue\nbad=1\nok=2\n";
+    CuAssertIntEquals(t, 1, test_ini_parse(errors, sizeof(errors) - 1));
+    CuAssertStrEquals(t, "|bad|1\n|ok|2\n", test_ini_calls);
+}
+
+void TestIniParseLongLines(CuTest *t)
+{
+    // Lines crossing the end of the read buffer
+    char text[3 * INI_BUFFER_SIZE];
+    text[0] = '\0';
+    for (int i = 0; strlen(text) < 2 * INI_BUFFER_SIZE; i++)
+        sprintf(text + strlen(text), "key%d=%d\n", i, i * 1000);
+    strcat(text, "end=1");
+    CuAssertIntEquals(t, 0, test_ini_parse(text, strlen(text)));
+    CuAssertTrue(t, strstr(test_ini_calls, "|key30|30000\n") != NULL);
+    CuAssertTrue(t, strstr(test_ini_calls, "|end=1\n") == NULL);
+    CuAssertTrue(t, strstr(test_ini_calls, "|end|1\n") != NULL);
+
+    // A line longer than the buffer is split like fgets did
+    memset(text, 'x', sizeof(text));
+    memcpy(text + INI_BUFFER_SIZE, "=1\nk=v\n", 7);
+    CuAssertIntEquals(t, 1, test_ini_parse(text, INI_BUFFER_SIZE + 7));
+    CuAssertStrEquals(t, "||1\n|k|v\n", test_ini_calls);
+}
@@ -0,0 +1,44 @@
+#include "CuTest.h"
+#include "target/tx/other/test/emu.h"
+
+static u8 expected[IMAGE_X * IMAGE_Y * 3];
+
+void TestImageCacheWindows(CuTest* t)
+{
+    const char *file = "media/backgrnd" IMG_EXT;
+    const u16 windows[][4] = {
+        {0, 0, LCD_WIDTH, LCD_HEIGHT},
+        {0, 0, 1, 1},
+        {37, 45, 61, 17},
+        {200, 100, 120, 140},
+        {LCD_WIDTH - 3, 20, 3, 200},
+    };
+
+    memset(&image_cache, 0, sizeof(image_cache));
+    LCD_Clear(0);
+    for (unsigned i = 0; i < sizeof(windows) / sizeof(windows[0]); i++) {
+        const u16 *win = windows[i];
+        LCD_DrawWindowedImageFromFile(win[0], win[1], file, win[2], win[3], win[0], win[1]);
+    }
+    memcpy(expected, gui.image, sizeof(expected));
+
+    CuAssertIntEquals(t, 1, LCD_CacheImage(file));
+    LCD_Clear(0);
+    for (unsigned i = 0; i < sizeof(windows) / sizeof(windows[0]); i++) {
+        const u16 *win = windows[i];
+        LCD_DrawWindowedImageFromFile(win[0], win[1], file, win[2], win[3], win[0], win[1]);
+    }
+    CuAssertTrue(t, memcmp(expected, gui.image, sizeof(expected)) == 0);
+}
+
+void TestImageCacheOverflow(CuTest* t)
+{
+    memset(&image_cache, 0, sizeof(image_cache));
+    const u16 noise[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    int pos = 0;
+    // Literal data costs a byte per pixel plus a control byte per 128 pixels
+    while (pos >= 0 && pos < (int)sizeof(image_cache.data))
+        pos = cache_encode_row(noise, 8, pos);
+    CuAssertIntEquals(t, -1, pos);
+    CuAssertIntEquals(t, 8, image_cache.num_colors);
+}
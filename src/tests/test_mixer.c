@@ -163,6 +163,52 @@ void TestCalcChannels(CuTest *t)
     }
 }
 
+void TestTakeChanges(CuTest *t)
+{
+    u32 changed[MIXER_CHANGE_WORDS];
+    memset(&Model, 0, sizeof(Model));
+    memset((s32 *)raw, 0, sizeof(raw));
+    Transmitter.mode = MODE_1;
+    for (int i = 1; i <= NUM_TX_INPUTS; i++) {
+        TEST_CHAN_SetChannelValue(i, 0);
+    }
+    Model.mixers[0].src = 1;
+    Model.mixers[0].dest = 0;
+    Model.mixers[0].scalar = 100;
+    Model.mixers[0].flags = MUX_REPLACE;
+    Model.limits[0].servoscale = 100;
+    Model.limits[0].max = 200;
+    Model.limits[0].min = 200;
+    Model.trims[0].src = 2;
+    Model.trims[0].sw = 3;
+    MIXER_CalcChannels();
+    MIXER_TakeChanges(changed);
+
+    // Nothing moved
+    MIXER_CalcChannels();
+    MIXER_TakeChanges(changed);
+    for (int i = 0; i < MIXER_CHANGE_WORDS; i++)
+        CuAssertIntEquals(t, 0, changed[i]);
+
+    // Input 1 feeds channel 1, input 3 switches trim 1
+    TEST_CHAN_SetChannelValue(1, 5000);
+    TEST_CHAN_SetChannelValue(3, 5000);
+    MIXER_CalcChannels();
+    MIXER_CalcChannels();
+    MIXER_TakeChanges(changed);
+    CuAssertIntEquals(t, 1, MIXER_CHANGED(changed, 1));
+    CuAssertIntEquals(t, 0, MIXER_CHANGED(changed, 2));
+    CuAssertIntEquals(t, 1, MIXER_CHANGED(changed, NUM_INPUTS + 1));
+    CuAssertIntEquals(t, 0, MIXER_CHANGED(changed, NUM_INPUTS + 2));
+    CuAssertIntEquals(t, 1, MIXER_CHANGED(changed, MIXER_CHANGE_TRIM(0)));
+    CuAssertIntEquals(t, 0, MIXER_CHANGED(changed, MIXER_CHANGE_TRIM(1)));
+
+    // Changes are only reported once
+    MIXER_TakeChanges(changed);
+    for (int i = 0; i < MIXER_CHANGE_WORDS; i++)
+        CuAssertIntEquals(t, 0, changed[i]);
+}
+
 void TestGetInputs(CuTest *t)
 {
     CuAssertPtrEquals(t, (void *)raw, (void *)MIXER_GetInputs());
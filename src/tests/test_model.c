@@ -38,3 +38,55 @@ void TestModelChange(CuTest *t)
 
     CuAssertTrue(t, CONFIG_IsModelChanged());
 }
+
+void TestModelCrc(CuTest *t)
+{
+    // Protocol ids are derived from Crc(), so it must stay the standard CRC32
+    CuAssertIntEquals(t, 0xCBF43926, Crc("123456789", 9));
+    CuAssertIntEquals(t, 0, Crc("", 0));
+}
+
+void TestModelChangeScan(CuTest *t)
+{
+    CONFIG_ResetModel();
+    CONFIG_ChangesReset(&changes);
+    CuAssertTrue(t, ! CONFIG_IsModelChanged());
+    CuAssertTrue(t, ! CONFIG_ScanChanges(&changes));
+
+    // Change the last section so the scan has to wrap around to find it
+    ((u8 *)&Model)[sizeof(Model) - 1] ^= 0x01;
+    int scans = 1;
+    while (! CONFIG_ScanChanges(&changes) && scans < 100)
+        scans++;
+    CuAssertTrue(t, scans >= CONFIG_SAVE_DELAY);
+    CuAssertTrue(t, scans < CONFIG_SAVE_MAX_AGE);
+    CuAssertTrue(t, CONFIG_IsModelChanged());
+
+    ((u8 *)&Model)[sizeof(Model) - 1] ^= 0x01;
+    CONFIG_ResetModel();
+}
+
+void TestModelSourceNames(CuTest *t)
+{
+    char str[10];
+    unsigned val;
+    const char *alias;
+
+    for (int i = 0; i <= NUM_SOURCES; i++) {
+        CuAssertIntEquals(t, i, INPUT_FindSource(INPUT_SourceNameReal(str, i)));
+        int sw = INPUT_FindAbbrevSource(INPUT_SourceNameAbbrevSwitchReal(str, i));
+        CuAssertIntEquals(t, INPUT_SwitchPos(i) > 0 ? i - INPUT_SwitchPos(i) : i, sw);
+    }
+    for (int i = 0; i < 4; i++)
+        CuAssertIntEquals(t, i + 1, INPUT_FindSource(tx_stick_names[i]));
+    for (int i = 0; (alias = INPUT_MapSourceName(i, &val)); i++)
+        CuAssertIntEquals(t, val, INPUT_FindSource(alias));
+    for (int i = 0; i <= NUM_TX_BUTTONS; i++)
+        CuAssertIntEquals(t, i, INPUT_FindButton(INPUT_ButtonName(i)));
+
+    // case and ' '/'_' are folded
+    CuAssertIntEquals(t, NUM_INPUTS + 1, INPUT_FindSource("cH1"));
+    CuAssertIntEquals(t, 1, INPUT_FindSource("right h"));
+    CuAssertIntEquals(t, -1, INPUT_FindSource("Ch99"));
+    CuAssertIntEquals(t, -1, INPUT_FindButton("Ch1"));
+}
@@ -1,4 +1,5 @@
 #include "CuTest.h"
+#include "target/tx/other/test/draw_stats.h"
 
 extern void AssertScreenshot(CuTest* t, const char* testname);
 
@@ -8,6 +9,85 @@ static int page_attr[] = {
 };
 #undef PAGEDEF
 
+/* Draw-call budget per page: the first render after entering the page and
+ * one refresh tick (PAGE_Event + GUI_RefreshScreen) on the idle page.
+ * Counts are compared against tests/320x240x16/draw_stats.txt and the test
+ * fails if any of them grows.
+ */
+#define DRAW_STATS_FILE "../../tests/320x240x16/draw_stats.txt"
+#define DRAW_STATS_FIELDS 8
+
+static FILE *stats_out;
+
+static void write_stats(FILE *fh, const char *name, const struct draw_stats *render,
+                        const struct draw_stats *tick)
+{
+    fprintf(fh, "%s %u %u %u %u %u %u %u %u\n", name,
+            (unsigned)render->pixels, (unsigned)render->windows,
+            (unsigned)render->file_opens, (unsigned)render->file_bytes,
+            (unsigned)tick->pixels, (unsigned)tick->windows,
+            (unsigned)tick->file_opens, (unsigned)tick->file_bytes);
+}
+
+static int find_budget(const char *name, unsigned *budget)
+{
+    char line[256];
+    char page[128];
+    int found = 0;
+    FILE *fh = fopen(DRAW_STATS_FILE, "r");
+    if (! fh)
+        return -1;
+    while (! found && fgets(line, sizeof(line), fh)) {
+        found = sscanf(line, "%127s %u %u %u %u %u %u %u %u", page,
+                       &budget[0], &budget[1], &budget[2], &budget[3],
+                       &budget[4], &budget[5], &budget[6], &budget[7]) == DRAW_STATS_FIELDS + 1
+                && strcmp(page, name) == 0;
+    }
+    fclose(fh);
+    return found ? 1 : -1;
+}
+
+// Pages without a budget get their first counts appended to the baseline
+static int add_budget(const char *name, const struct draw_stats *render,
+                      const struct draw_stats *tick)
+{
+    FILE *fh = fopen(DRAW_STATS_FILE, "a");
+    if (! fh)
+        return 0;
+    write_stats(fh, name, render, tick);
+    fclose(fh);
+    return 1;
+}
+
+static int AssertDrawStats(const char *name, const struct draw_stats *render,
+                           const struct draw_stats *tick)
+{
+    static const char * const field[DRAW_STATS_FIELDS] = {
+        "pixels", "windows", "file opens", "file bytes",
+        "tick pixels", "tick windows", "tick file opens", "tick file bytes",
+    };
+    unsigned actual[DRAW_STATS_FIELDS] = {
+        render->pixels, render->windows, render->file_opens, render->file_bytes,
+        tick->pixels, tick->windows, tick->file_opens, tick->file_bytes,
+    };
+    unsigned budget[DRAW_STATS_FIELDS];
+
+    printf("%s: %u pixels, %u windows, %u opens, %u bytes read; tick: %u pixels, %u windows, %u bytes read\n",
+           name, actual[0], actual[1], actual[2], actual[3], actual[4], actual[5], actual[7]);
+    write_stats(stats_out, name, render, tick);
+
+    if (find_budget(name, budget) < 0)
+        return -1;
+    int ok = 1;
+    for (int i = 0; i < DRAW_STATS_FIELDS; i++) {
+        if (actual[i] > budget[i]) {
+            printf("%s: %s went up from %u to %u\n", name, field[i], budget[i], actual[i]);
+            ok = 0;
+        }
+    }
+    return ok;
+}
+
 void TestAllPages(CuTest* t)
 {
     char testname[256];
@@ -20,6 +100,10 @@ void TestAllPages(CuTest* t)
     Transmitter.audio_player = AUDIO_AUDIOFX;
     Transmitter.current_model = 1;
 
+    int missing = 0;
+    int failed = 0;
+    stats_out = fopen("draw_stats.txt", "w");
+
     PAGE_Init();
     for (int i = 0; i < PAGEID_LAST; i++) {
         if ((page_attr[i] & (MIXER_STANDARD | MIXER_ADVANCED))
@@ -52,8 +136,66 @@ void TestAllPages(CuTest* t)
             if (testname[j] == '&') testname[j] = '_';
             if (testname[j] == '/') testname[j] = '_';
         }
+        struct draw_stats render, tick;
+        memset(&draw_stats, 0, sizeof(draw_stats));
         PAGE_ChangeByID(i, 0);
         GUI_RefreshScreen();
+        render = draw_stats;
         AssertScreenshot(t, testname);
+
+        memset(&draw_stats, 0, sizeof(draw_stats));
+        PAGE_Event();
+        GUI_RefreshScreen();
+        tick = draw_stats;
+
+        int res = AssertDrawStats(testname, &render, &tick);
+        if (res < 0)
+            missing += add_budget(testname, &render, &tick);
+        else if (! res)
+            failed++;
+    }
+    fclose(stats_out);
+    if (missing)
+        printf("Added %d pages to draw statistics. Please add %s to git repo.\n", missing, DRAW_STATS_FILE);
+    if (failed)
+        CuFail(t, "Draw statistics regressed! Check filesystem/test/draw_stats.txt for actual counts.\n");
+}
+
+void TestMainPageToggleReinit(CuTest* t)
+{
+    struct mainpage_obj *gui = &gui_objs.u.mainpage;
+    objHEAD = NULL;
+    CONFIG_ResetModel();
+    PAGE_Init();
+
+    // One toggle showing icon 1 in GEAR0 and nothing in GEAR1
+    struct elem *elem = &Model.pagecfg2.elem[0];
+    memset(elem, 0, sizeof(*elem));
+    ELEM_SET_X(*elem, 10);
+    ELEM_SET_Y(*elem, 40);
+    ELEM_SET_TYPE(*elem, ELEM_TOGGLE);
+    elem->src = INP_GEAR0;
+    ELEM_ICO(*elem, 0) = 1;
+
+    volatile s32 *raw = MIXER_GetInputs();
+    raw[INP_GEAR0] = CHAN_MIN_VALUE;
+    raw[INP_GEAR1] = CHAN_MAX_VALUE;
+    u32 changed[MIXER_CHANGE_WORDS];
+    for (int i = 0; i < 2; i++) {
+        // Re-entering the page must show the current switch state even
+        // though the switch has not moved since the previous visit
+        PAGE_ChangeByID(PAGEID_MAIN, 0);
+        MIXER_TakeChanges(changed);
+        PAGE_Event();
+        CuAssertTrue(t, OBJ_IS_HIDDEN((guiObject_t *)&gui->elem[0]));
     }
+    raw[INP_GEAR0] = CHAN_MAX_VALUE;
+    raw[INP_GEAR1] = CHAN_MIN_VALUE;
+    PAGE_ChangeByID(PAGEID_MAIN, 0);
+    MIXER_TakeChanges(changed);
+    PAGE_Event();
+    CuAssertTrue(t, ! OBJ_IS_HIDDEN((guiObject_t *)&gui->elem[0]));
+
+    memset(elem, 0, sizeof(*elem));
+    PAGE_ChangeByID(PAGEID_MAIN, 0);
 }
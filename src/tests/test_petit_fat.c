@@ -0,0 +1,186 @@
+#include <string.h>
+#include "CuTest.h"
+
+/* A FAT12 image with one 4k sector per cluster:
+ * sector 0: boot sector, 1: FAT, 2: root directory, 3+: clusters 2.. */
+#define TEST_SECTORS 35
+#define TEST_DATA    3
+
+static BYTE test_image[TEST_SECTORS * SECTOR_SIZE];
+
+/* FRAG.BIN is spread over 8 runs, more than the map holds */
+static const CLUST test_chain[] = {2, 3, 10, 5, 6, 20, 8, 15, 16, 25, 30, 31};
+#define TEST_MAPPED  9   /* Clusters in the first _FASTSEEK_RUNS runs */
+#define TEST_FSIZE   (sizeof(test_chain) / sizeof(test_chain[0]) * SECTOR_SIZE - 5)
+
+DSTATUS disk_initialize(void)
+{
+    return 0;
+}
+
+DRESULT disk_readp(BYTE *dest, DWORD sector, WORD sofs, WORD count)
+{
+    if (sector >= TEST_SECTORS || sofs + count > SECTOR_SIZE)
+        return RES_PARERR;
+    if (dest)
+        memcpy(dest, test_image + sector * SECTOR_SIZE + sofs, count);
+    return RES_OK;
+}
+
+DRESULT disk_readp_cnt(BYTE *dest, DWORD sector, WORD sofs, WORD count, WORD *actual)
+{
+    *actual = count;
+    return disk_readp(dest, sector, sofs, count);
+}
+
+DRESULT disk_writep_rand(const BYTE *src, DWORD sector, WORD sofs, WORD count)
+{
+    if (sector >= TEST_SECTORS || sofs + count > SECTOR_SIZE)
+        return RES_PARERR;
+    memcpy(test_image + sector * SECTOR_SIZE + sofs, src, count);
+    return RES_OK;
+}
+
+DRESULT disk_erasep(DWORD sc)
+{
+    if (sc >= TEST_SECTORS)
+        return RES_PARERR;
+    memset(test_image + sc * SECTOR_SIZE, 0xff, SECTOR_SIZE);
+    return RES_OK;
+}
+
+DRESULT disk_writep(const BYTE *buff, DWORD sc)
+{
+    static DWORD pos;
+    if (!buff) {
+        pos = sc * SECTOR_SIZE;
+        return sc ? disk_erasep(sc) : RES_OK;
+    }
+    if (pos + sc > sizeof(test_image))
+        return RES_PARERR;
+    memcpy(test_image + pos, buff, sc);
+    pos += sc;
+    return RES_OK;
+}
+
+static BYTE test_byte(DWORD ofs)
+{
+    return ofs * 7 + ofs / SECTOR_SIZE;
+}
+
+static void test_set_fat(CLUST clst, WORD val)
+{
+    BYTE *p = test_image + SECTOR_SIZE + clst + clst / 2;
+    if (clst & 1) {
+        p[0] = (p[0] & 0x0f) | (val << 4);
+        p[1] = val >> 4;
+    } else {
+        p[0] = val;
+        p[1] = (p[1] & 0xf0) | (val >> 8);
+    }
+}
+
+static void test_image_reset()
+{
+    BYTE *boot = test_image, *dir = test_image + 2 * SECTOR_SIZE;
+    unsigned i;
+    DWORD ofs;
+
+    memset(test_image, 0, sizeof(test_image));
+    boot[BPB_SecPerClus] = 1;
+    ST_WORD(boot + BPB_RsvdSecCnt, 1);
+    boot[BPB_NumFATs] = 1;
+    ST_WORD(boot + BPB_RootEntCnt, DIR_ENTRIES_PER_SECTOR);
+    ST_WORD(boot + BPB_TotSec16, TEST_SECTORS);
+    ST_WORD(boot + BPB_FATSz16, 1);
+    memcpy(boot + BS_FilSysType, "FAT12   ", 8);
+    ST_WORD(boot + BS_55AA, 0xAA55);
+
+    test_set_fat(0, 0xff8);
+    test_set_fat(1, 0xfff);
+    for (i = 0; i < sizeof(test_chain) / sizeof(test_chain[0]); i++) {
+        CLUST next = i + 1 < sizeof(test_chain) / sizeof(test_chain[0]) ? test_chain[i + 1] : 0xfff;
+        test_set_fat(test_chain[i], next);
+    }
+    for (ofs = 0; ofs < TEST_FSIZE; ofs++)
+        test_image[(TEST_DATA + test_chain[ofs / SECTOR_SIZE] - 2) * SECTOR_SIZE + ofs % SECTOR_SIZE] = test_byte(ofs);
+
+    memcpy(dir + DIR_Name, "FRAG    BIN", 11);
+    dir[DIR_Attr] = AM_ARC;
+    ST_WORD(dir + DIR_FstClusLO, test_chain[0]);
+    ST_DWORD(dir + DIR_FileSize, TEST_FSIZE);
+}
+
+static void AssertReadAt(CuTest *t, DWORD ofs)
+{
+    BYTE buf[64];
+    WORD br, i;
+
+    CuAssertIntEquals(t, FR_OK, pf_lseek(ofs));
+    CuAssertIntEquals(t, FR_OK, pf_read(buf, sizeof(buf), &br));
+    CuAssertIntEquals(t, ofs + sizeof(buf) > TEST_FSIZE ? TEST_FSIZE - ofs : sizeof(buf), br);
+    for (i = 0; i < br; i++)
+        CuAssertIntEquals(t, test_byte(ofs + i), buf[i]);
+}
+
+static void test_open(CuTest *t, FATFS *fs)
+{
+    test_image_reset();
+    CuAssertIntEquals(t, FR_OK, pf_mount(fs));
+    CuAssertIntEquals(t, FR_OK, pf_open("FRAG.BIN"));
+}
+
+void TestPetitFatFastSeek(CuTest *t)
+{
+    FATFS fs;
+    BYTE buf[1000];
+    WORD br, i;
+    DWORD ofs;
+    int idx;
+
+    test_open(t, &fs);
+    // Sequential reads follow the FAT
+    for (ofs = 0; ofs < TEST_FSIZE; ofs += br) {
+        CuAssertIntEquals(t, FR_OK, pf_read(buf, sizeof(buf), &br));
+        CuAssertTrue(t, br > 0);
+        for (i = 0; i < br; i++)
+            CuAssertIntEquals(t, test_byte(ofs + i), buf[i]);
+    }
+    CuAssertIntEquals(t, TEST_FSIZE, ofs);
+
+    // Seeks land on the right cluster backwards, forwards and across runs
+    for (idx = sizeof(test_chain) / sizeof(test_chain[0]) - 1; idx >= 0; idx--) {
+        AssertReadAt(t, idx * SECTOR_SIZE);
+        AssertReadAt(t, idx * SECTOR_SIZE + SECTOR_SIZE - 10);
+    }
+    for (idx = 0; idx < (int)(sizeof(test_chain) / sizeof(test_chain[0])); idx += 3)
+        AssertReadAt(t, idx * SECTOR_SIZE + 123);
+    AssertReadAt(t, TEST_FSIZE - 1);
+    CuAssertIntEquals(t, _FASTSEEK_RUNS, fs.map_runs);
+    CuAssertIntEquals(t, TEST_MAPPED, fs.map_len);
+
+    pf_mount(NULL);
+}
+
+void TestPetitFatSeekPastMap(CuTest *t)
+{
+    FATFS fs;
+
+    test_open(t, &fs);
+    AssertReadAt(t, 100);
+    CuAssertIntEquals(t, TEST_MAPPED, fs.map_len);
+
+    // Break the chain inside the map, a walk from the first cluster now fails
+    test_set_fat(test_chain[2], 0);
+    fat_cache_sect = 0;
+
+    AssertReadAt(t, 0);
+    AssertReadAt(t, 11 * SECTOR_SIZE + 5);
+    AssertReadAt(t, 1 * SECTOR_SIZE + 7);
+    AssertReadAt(t, 10 * SECTOR_SIZE + 4000);
+    AssertReadAt(t, 3 * SECTOR_SIZE - 20);
+    AssertReadAt(t, (TEST_MAPPED - 1) * SECTOR_SIZE + SECTOR_SIZE - 30);
+    CuAssertTrue(t, fs.flag & FA_OPENED);
+
+    pf_mount(NULL);
+}
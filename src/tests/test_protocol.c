@@ -0,0 +1,211 @@
+#include <time.h>
+#include "CuTest.h"
+
+/* Golden-trace regression test for protocol packet generation.
+ * Every protocol is initialised, run for PROTO_TEST_PACKETS timer ticks,
+ * bound and run again against the recording SPI/UART stubs.  The resulting
+ * bus trace is compared with tests/protocol/<name>.trace
+ */
+#define PROTO_TEST_PACKETS 16
+
+extern u16 (*timer_callback)(void);
+
+struct proto_timing {
+    unsigned packets;
+    u64 total_ns;
+    u64 max_ns;
+};
+
+static u64 now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void run_packets(struct proto_timing *timing)
+{
+    for (int i = 0; i < PROTO_TEST_PACKETS && timer_callback; i++) {
+        u64 start = now_ns();
+        unsigned us = timer_callback();
+        u64 elapsed = now_ns() - start;
+        timing->packets++;
+        timing->total_ns += elapsed;
+        if (elapsed > timing->max_ns)
+            timing->max_ns = elapsed;
+        TRACE_Log("+%u", us);
+        if (! us)
+            CLOCK_StopTimer();
+    }
+}
+
+static void write_trace(const char *filename, const char *trace)
+{
+    FILE *fh = fopen(filename, "w");
+    if (fh) {
+        fputs(trace, fh);
+        fclose(fh);
+    }
+}
+
+static char *read_trace(const char *filename)
+{
+    FILE *fh = fopen(filename, "r");
+    if (! fh)
+        return NULL;
+    fseek(fh, 0, SEEK_END);
+    long len = ftell(fh);
+    fseek(fh, 0, SEEK_SET);
+    char *data = malloc(len + 1);
+    len = fread(data, 1, len, fh);
+    data[len] = 0;
+    fclose(fh);
+    return data;
+}
+
+static int AssertTrace(CuTest *t, const char *name, const char *trace)
+{
+    char filename[30];
+    char filepath[100];
+    // protocol names may contain spaces
+    strlcpy(filename, name, sizeof(filename));
+    for (char *ptr = filename; *ptr; ptr++)
+        if (*ptr == ' ')
+            *ptr = '_';
+    snprintf(filepath, sizeof(filepath), "../../tests/protocol/%s.trace", filename);
+
+    char *expected = read_trace(filepath);
+    if (! expected) {
+        printf("Missing expected trace. Please add %s to git repo.\n", filepath);
+        write_trace(filepath, trace);
+        return 1;
+    }
+    int line = 1;
+    const char *a = expected, *b = trace;
+    while (*a && *a == *b) {
+        if (*a == '\n')
+            line++;
+        a++;
+        b++;
+    }
+    int match = (*a == *b);
+    free(expected);
+    if (! match) {
+        char msg[150];
+        snprintf(msg, sizeof(msg), "Trace %s differs at line %d! Check filesystem/test/ for actual content.\n", name, line);
+        snprintf(filepath, sizeof(filepath), "%s.trace", filename);
+        write_trace(filepath, trace);
+        CuFail_Line(t, __FILE__, __LINE__, NULL, msg);
+    }
+    return match;
+}
+
+void TestProtocolTraces(CuTest *t)
+{
+    static struct Model saved_model;
+    struct mcu_pin saved_enable[TX_MODULE_LAST];
+    s32 saved_channels[NUM_OUT_CHANNELS];
+    int failed = 0;
+
+    saved_model = Model;
+    memcpy(saved_enable, Transmitter.module_enable, sizeof(saved_enable));
+    memcpy(saved_channels, (s32 *)Channels, sizeof(saved_channels));
+    // Don't depend on whatever model the earlier tests left behind
+    CONFIG_ResetModel();
+
+    // Give every SPI module its own chip select
+    for (int i = 0; i < MULTIMOD; i++) {
+        Transmitter.module_enable[i].port = 0xAAAAAAAA;
+        Transmitter.module_enable[i].pin = 1 << i;
+    }
+    Transmitter.module_enable[MULTIMOD].port = 0;
+
+    for (int i = 0; i < NUM_OUT_CHANNELS; i++)
+        Channels[i] = (i % 5 - 2) * CHAN_MAX_VALUE / 2;
+
+    for (int proto = 1; proto < PROTOCOL_COUNT; proto++) {
+        struct proto_timing timing = {0, 0, 0};
+
+        Model.protocol = proto;
+        Model.fixed_id = 0x00123456;
+        Model.tx_power = TXPOWER_10mW;
+        memset(Model.proto_opts, 0, sizeof(Model.proto_opts));
+        PROTOCOL_Load(1);
+        if (! PROTOCOL_LOADED)
+            continue;
+        Model.num_channels = PROTOCOL_DefaultNumChannels();
+        srand(1);
+
+        TRACE_Start();
+        TRACE_Log("INIT");
+        PROTOCOL_Init(1);
+        run_packets(&timing);
+        TRACE_Log("BIND");
+        PROTOCOL_Bind();
+        run_packets(&timing);
+        TRACE_Log("DEINIT");
+        PROTOCOL_DeInit();
+        unsigned spi_bytes = TRACE_SPIBytes();
+        const char *trace = TRACE_Stop();
+
+        if (timing.packets) {
+            printf("%s: %d packets, %d SPI bytes, %d ns/packet (max %d ns)\n",
+                   Protocols[proto].name, (int)timing.packets, (int)spi_bytes,
+                   (int)(timing.total_ns / timing.packets), (int)timing.max_ns);
+        }
+        if (! AssertTrace(t, Protocols[proto].name, trace))
+            failed++;
+    }
+
+    Model = saved_model;
+    memcpy(Transmitter.module_enable, saved_enable, sizeof(saved_enable));
+    memcpy((s32 *)Channels, saved_channels, sizeof(saved_channels));
+    CuAssertIntEquals(t, 0, failed);
+}
+
+void TestLz4Decompress(CuTest *t)
+{
+    // "abcd", copy 8 from 4 back, then "xyz" as the final literals
+    static const u8 block[] = {0x44, 'a', 'b', 'c', 'd', 0x04, 0x00, 0x30, 'x', 'y', 'z'};
+    // 20 literals (15 + 5) and a 20 byte run from 1 back (4 + 15 + 1)
+    static const u8 ext[] = {0xff, 0x05, 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j',
+                             'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 0x01, 0x00, 0x01};
+    const char *expect = "abcdabcdabcdxyz";
+    u8 out[64];
+
+    memset(out, 0xaa, sizeof(out));
+    CuAssertIntEquals(t, 15, lz4_decompress(block, sizeof(block), out, 15));
+    CuAssertTrue(t, memcmp(out, expect, 15) == 0);
+    CuAssertIntEquals(t, 0xaa, out[15]);
+
+    CuAssertIntEquals(t, 40, lz4_decompress(ext, sizeof(ext), out, sizeof(out)));
+    CuAssertTrue(t, memcmp(out, "abcdefghijklmnopqrst", 20) == 0);
+    for (int i = 20; i < 40; i++)
+        CuAssertIntEquals(t, 't', out[i]);
+
+    // Output which doesn't fit is rejected, and nothing is written past it
+    memset(out, 0xaa, sizeof(out));
+    CuAssertIntEquals(t, -1, lz4_decompress(block, sizeof(block), out, 14));
+    CuAssertIntEquals(t, 0xaa, out[14]);
+    CuAssertIntEquals(t, -1, lz4_decompress(ext, sizeof(ext), out, 39));
+
+    // Truncated input never produces the whole output
+    for (unsigned len = 0; len < sizeof(block); len++) {
+        memset(out, 0xaa, sizeof(out));
+        CuAssertTrue(t, lz4_decompress(block, len, out, 15) != 15);
+        CuAssertIntEquals(t, 0xaa, out[15]);
+    }
+    for (unsigned len = 0; len < sizeof(ext); len++)
+        CuAssertTrue(t, lz4_decompress(ext, len, out, sizeof(out)) != 40);
+
+    // Matches reaching before the start of the output
+    u8 bad[sizeof(block)];
+    memcpy(bad, block, sizeof(bad));
+    bad[5] = 0x00;
+    CuAssertIntEquals(t, -1, lz4_decompress(bad, sizeof(bad), out, sizeof(out)));
+    bad[5] = 0x05;
+    CuAssertIntEquals(t, -1, lz4_decompress(bad, sizeof(bad), out, sizeof(out)));
+    // A literal length running past the input
+    bad[0] = 0x54;
+    CuAssertIntEquals(t, -1, lz4_decompress(bad, sizeof(bad), out, sizeof(out)));
+}
@@ -0,0 +1,116 @@
+#include "CuTest.h"
+
+void TestTelemetryAlarmHysteresis(CuTest *t)
+{
+    struct TelemetryAlarm *alarm = &Model.alarms[0];
+    memset(alarm, 0, sizeof(*alarm));
+    TELEMETRY_SetType(TELEM_DEVO);
+    alarm->src = TELEM_DEVO_VOLT1;
+    alarm->value = 100;
+    alarm->above = 1;  // alarm when voltage <= 10.0V
+
+    Telemetry.value[TELEM_DEVO_VOLT1] = 110;
+    _check_alarm(0, 1000);
+    CuAssertIntEquals(t, 0, alarm->state);
+
+    Telemetry.value[TELEM_DEVO_VOLT1] = 100;
+    _check_alarm(0, 1000);
+    CuAssertIntEquals(t, 1, alarm->state);
+    CuAssertIntEquals(t, 1000, alarm->limit_threshold_time);
+
+    // Must rise past the hysteresis band before clearing
+    s32 hyst = _alarm_hysteresis(TELEM_DEVO_VOLT1);
+    CuAssertTrue(t, hyst > 0);
+    Telemetry.value[TELEM_DEVO_VOLT1] = 100 + hyst;
+    _check_alarm(0, 2000);
+    CuAssertIntEquals(t, 1, alarm->state);
+    Telemetry.value[TELEM_DEVO_VOLT1] = 101 + hyst;
+    _check_alarm(0, 2000);
+    CuAssertIntEquals(t, 0, alarm->state);
+
+    alarm->threshold = 3;
+    Telemetry.value[TELEM_DEVO_VOLT1] = 90;
+    _check_alarm(0, 5000);
+    CuAssertIntEquals(t, 1, alarm->state);
+    CuAssertIntEquals(t, 8000, alarm->limit_threshold_time);
+    memset(alarm, 0, sizeof(*alarm));
+}
+
+void TestTelemetryUpdatedQueue(CuTest *t)
+{
+    memset((void *)pending, 0, sizeof(pending));
+    TELEMETRY_SetUpdated(TELEM_DEVO_VOLT2);
+    TELEMETRY_SetUpdated(TELEM_GPS_HEADING);
+    CuAssertTrue(t, (pending[TELEM_DEVO_VOLT2 / 32] >> (TELEM_DEVO_VOLT2 % 32)) & 1);
+    CuAssertTrue(t, (pending[TELEM_GPS_HEADING / 32] >> (TELEM_GPS_HEADING % 32)) & 1);
+    CuAssertTrue(t, TELEMETRY_IsUpdated(TELEM_DEVO_VOLT2));
+    memset((void *)pending, 0, sizeof(pending));
+}
+
+void TestTelemetryHistory(CuTest *t)
+{
+    s32 samples[TELEM_HIST_DEPTH];
+    struct TelemetryStats stats;
+
+    memset(history, 0, sizeof(history));
+    TELEMETRY_SetType(TELEM_DEVO);
+    CuAssertIntEquals(t, -1, TELEMETRY_HistorySubscribe(0));
+    int slot = TELEMETRY_HistorySubscribe(TELEM_DEVO_VOLT1);
+    CuAssertTrue(t, slot >= 0);
+    CuAssertIntEquals(t, slot, TELEMETRY_HistorySubscribe(TELEM_DEVO_VOLT1));
+    CuAssertIntEquals(t, 0, TELEMETRY_GetStats(TELEM_DEVO_VOLT1, &stats));
+
+    struct telem_history *h = &history[slot];
+    for (int i = 1; i <= 25; i++)
+        _record_value(h, i * 10);
+    CuAssertIntEquals(t, 1, TELEMETRY_GetStats(TELEM_DEVO_VOLT1, &stats));
+    CuAssertIntEquals(t, 10, stats.min);
+    CuAssertIntEquals(t, 250, stats.max);
+    CuAssertIntEquals(t, 130, stats.avg);
+    CuAssertIntEquals(t, 25, stats.count);
+
+    CuAssertIntEquals(t, 3, TELEMETRY_GetHistory(TELEM_DEVO_VOLT1, TELEM_HIST_100MS, samples, 3));
+    CuAssertIntEquals(t, 250, samples[0]);
+    CuAssertIntEquals(t, 230, samples[2]);
+    // two full decimation windows have been folded into the 1s tier
+    CuAssertIntEquals(t, 2, TELEMETRY_GetHistory(TELEM_DEVO_VOLT1, TELEM_HIST_1SEC, samples, TELEM_HIST_DEPTH));
+    CuAssertIntEquals(t, 155, samples[0]);
+    CuAssertIntEquals(t, 55, samples[1]);
+    CuAssertIntEquals(t, 0, TELEMETRY_GetHistory(TELEM_DEVO_VOLT1, TELEM_HIST_10SEC, samples, TELEM_HIST_DEPTH));
+
+    TELEMETRY_ResetHistory();
+    CuAssertIntEquals(t, 0, TELEMETRY_GetStats(TELEM_DEVO_VOLT1, &stats));
+    // The mean is exact, including for negative values
+    const s32 vals[] = {-7, 3, -2, 0, 5, -1000, 1001};
+    s32 sum = 0;
+    for (unsigned i = 0; i < sizeof(vals) / sizeof(vals[0]); i++) {
+        _record_value(h, vals[i]);
+        sum += vals[i];
+        TELEMETRY_GetStats(TELEM_DEVO_VOLT1, &stats);
+        s32 floor_avg = sum / (s32)(i + 1);
+        if (floor_avg * (s32)(i + 1) > sum)
+            floor_avg--;
+        CuAssertIntEquals(t, floor_avg, stats.avg);
+    }
+    CuAssertIntEquals(t, -1000, stats.min);
+
+    // Only sources reported since the last sample are recorded
+    memset((void *)history_fresh, 0, sizeof(history_fresh));
+    TELEMETRY_SetUpdated(TELEM_DEVO_VOLT1);
+    CuAssertTrue(t, (history_fresh[TELEM_DEVO_VOLT1 / 32] >> (TELEM_DEVO_VOLT1 % 32)) & 1);
+    memset((void *)history_fresh, 0, sizeof(history_fresh));
+    memset((void *)pending, 0, sizeof(pending));
+
+    // The slot stays until every subscriber has left, resets keep them
+    TELEMETRY_ResetHistory();
+    CuAssertIntEquals(t, slot, TELEMETRY_HistorySubscribe(TELEM_DEVO_VOLT1));
+    _record_value(h, 5);
+    for (int i = 0; i < 2; i++) {
+        TELEMETRY_HistoryUnsubscribe(TELEM_DEVO_VOLT1);
+        CuAssertIntEquals(t, 1, TELEMETRY_GetHistory(TELEM_DEVO_VOLT1, TELEM_HIST_100MS, samples, 1));
+    }
+    TELEMETRY_HistoryUnsubscribe(TELEM_DEVO_VOLT1);
+    CuAssertIntEquals(t, 0, TELEMETRY_GetHistory(TELEM_DEVO_VOLT1, TELEM_HIST_100MS, samples, 1));
+    TELEMETRY_HistoryUnsubscribe(TELEM_DEVO_VOLT1);
+    CuAssertIntEquals(t, 0, history[slot].users);
+}
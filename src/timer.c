@@ -23,6 +23,7 @@
 static u8 timer_state[NUM_TIMERS];
 static s32 timer_val[NUM_TIMERS];
 static s32 last_time[NUM_TIMERS];
+static u8 timer_changes;  // timers whose displayed value changed
 
 void TIMER_SetString(char *str, s32 time)
 {
@@ -85,6 +86,7 @@ void TIMER_Reset(unsigned timer)
     } else if(Model.timer[timer].type == TIMER_PERMANENT ) {
         timer_val[timer] = Model.timer[timer].val;
     }
+    timer_changes |= 1 << timer;
 }
 
 s32 TIMER_GetValue(unsigned timer)
@@ -96,9 +98,19 @@ void TIMER_SetValue(unsigned timer, s32 value)
 {
     if (Model.timer[timer].type == TIMER_PERMANENT) {
         timer_val[timer] = value;
+        timer_changes |= 1 << timer;
     }
 }
 
+/* Returns a bitmask of the timers whose shown value (whole seconds or
+ * sign) changed since the previous call */
+unsigned TIMER_TakeChanges()
+{
+    unsigned changes = timer_changes;
+    timer_changes = 0;
+    return changes;
+}
+
 void TIMER_Init()
 {
     unsigned i;
@@ -146,6 +158,7 @@ void TIMER_Update()
     if( Transmitter.power_alarm > 0 )
         TIMER_Power();
     for (i = 0; i < NUM_TIMERS; i++) {
+        s32 old_val = timer_val[i];
         if (Model.timer[i].src) {
             s32 val;
             if (MIXER_SRC(Model.timer[i].src) <= NUM_INPUTS) {
@@ -247,6 +260,8 @@ void TIMER_Update()
             }
             last_time[i] = t;
         }
+        if (old_val / 1000 != timer_val[i] / 1000 || (old_val < 0) != (timer_val[i] < 0))
+            timer_changes |= 1 << i;
         if (Model.timer[i].resetsrc) {
             s32 val;
             if (MIXER_SRC(Model.timer[i].resetsrc) <= NUM_INPUTS) {
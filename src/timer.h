@@ -40,6 +40,7 @@ void TIMER_StartStop(unsigned timer);
 void TIMER_Reset(unsigned timer);
 s32 TIMER_GetValue(unsigned timer);
 void TIMER_SetValue(unsigned timer, s32 value);
+unsigned TIMER_TakeChanges();
 void TIMER_Update();
 void TIMER_Init();
 #endif
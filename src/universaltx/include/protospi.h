@@ -7,6 +7,7 @@
 
 u8 PROTOSPI_read3wire();
 uint8_t spi_xfer8(uint32_t spi, uint8_t data);
+void PROTOSPI_write(const u8 *data, int len);
 
 #define spi_xfer             DO_NOT_USE
 #define PROTOSPI_pin_set     PORT_pin_set
@@ -61,6 +61,12 @@ u8 PROTOSPI_read3wire(){
     return data;
 }
 
+void PROTOSPI_write(const u8 *data, int len)
+{
+    for (int i = 0; i < len; i++)
+        spi_xfer8(SPI2, data[i]);
+}
+
 void exti4_15_isr(void)
 {
     if (exti_get_flag_status(PASSTHRU_CSN.pin)) {
@@ -18,6 +18,12 @@ foreach (@files) {
     }
 }
 print "ALL += \$(PROTO_MODULES)\n";
+print "PROTO_PACK := \$(ODIR)/protocol/modules.pak\n";
+print "ALL += \$(PROTO_PACK)\n";
 print "else #BUILD_TARGET\n";
+print "\$(PROTO_PACK) : \$(PROTO_MODULES) protocol/protocol.h \$(SDIR)/../utils/pack_modules.py\n";
+print "\t\@echo Building module archive\n";
+print "\t\$(SDIR)/../utils/pack_modules.py --header protocol/protocol.h \$\@ \$(PROTO_MODULES)\n";
+print "\n";
 print @target;
 print "endif #BUILD_TARGET\n";
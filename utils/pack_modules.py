@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+"""Pack protocol modules into a single compressed archive.
+
+Usage:
+    pack_modules.py [--header protocol/protocol.h] [--max 4096] <out.pak> <module.mod>...
+
+Every module is LZ4 (block format) compressed and stored once, even when
+several protocols share it (DSM2/DSMX, WK2x01, ...).  The archive starts with
+an index keyed by the protocol name as shown in the GUI, so the firmware no
+longer has to derive an 8.3 filename from the protocol name.
+
+Layout (little endian):
+    "DMOD" u16 version u16 count
+    count * { char name[16]; u32 offset; u16 size; u16 packed; }
+    module data
+
+The firmware decompresses in place: the packed data is read to the end of
+the module RAM region and expanded towards its start.  A module for which
+that would overwrite unread input is stored uncompressed (packed == size).
+"""
+
+import os
+import re
+import struct
+import sys
+from optparse import OptionParser
+
+MAGIC = b"DMOD"
+VERSION = 1
+NAME_LEN = 16
+MIN_MATCH = 4
+LAST_LITERALS = 5   # LZ4: the last 5 bytes are always literals
+MF_LIMIT = 12       # LZ4: no match may start within the last 12 bytes
+
+# Module filenames which are not the (truncated) protocol name
+ALIASES = {
+    "xn297dmp": "XN297Dump",
+}
+
+def protocol_names(header):
+    with open(header) as fh:
+        return re.findall(r'^\s*PROTODEF\([^"]*"([^"]+)"\)', fh.read(), re.M)
+
+def module_name(filename, names):
+    base = os.path.splitext(os.path.basename(filename))[0].lower()
+    if base in ALIASES:
+        return ALIASES[base]
+    norm = lambda s: re.sub(r'[^a-z0-9-]', '', s.lower())
+    for name in names:
+        if name.lower() == base or name.lower()[:8] == base or norm(name) == base:
+            return name
+    sys.stderr.write("WARNING: No protocol found for %s\n" % filename)
+    return base
+
+def _write_len(out, length):
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+
+def lz4_compress(data):
+    out = bytearray()
+    table = {}
+    anchor = 0
+    pos = 0
+    end = len(data)
+    while pos < end - MF_LIMIT:
+        key = data[pos:pos + MIN_MATCH]
+        ref = table.get(key)
+        table[key] = pos
+        if ref is None or pos - ref > 0xffff:
+            pos += 1
+            continue
+        length = MIN_MATCH
+        while pos + length < end - LAST_LITERALS and data[ref + length] == data[pos + length]:
+            length += 1
+        literals = pos - anchor
+        token = (min(literals, 15) << 4) | min(length - MIN_MATCH, 15)
+        out.append(token)
+        if literals >= 15:
+            _write_len(out, literals - 15)
+        out += data[anchor:pos]
+        out += struct.pack("<H", pos - ref)
+        if length - MIN_MATCH >= 15:
+            _write_len(out, length - MIN_MATCH - 15)
+        pos += length
+        anchor = pos
+    literals = end - anchor
+    out.append(min(literals, 15) << 4)
+    if literals >= 15:
+        _write_len(out, literals - 15)
+    out += data[anchor:]
+    return bytes(out)
+
+def _read_len(src, ip, length):
+    if length == 15:
+        while True:
+            b = src[ip]
+            ip += 1
+            length += b
+            if b != 255:
+                break
+    return ip, length
+
+def lz4_decompress_in_place(src, size, region):
+    """Mirror of the firmware decoder.  Returns None if the output would
+    overrun input that has not been consumed yet"""
+    base = region - len(src)
+    out = bytearray(size)
+    ip = 0
+    op = 0
+    while True:
+        token = src[ip]
+        ip += 1
+        ip, literals = _read_len(src, ip, token >> 4)
+        if op + literals > base + ip + literals:
+            return None
+        out[op:op + literals] = src[ip:ip + literals]
+        op += literals
+        ip += literals
+        if ip >= len(src):
+            break
+        offset = src[ip] | (src[ip + 1] << 8)
+        ip += 2
+        ip, length = _read_len(src, ip, token & 0x0f)
+        length += MIN_MATCH
+        if op + length > base + ip and ip < len(src):
+            return None
+        for i in range(length):
+            out[op + i] = out[op - offset + i]
+        op += length
+    return bytes(out) if op == size else None
+
+def main():
+    parser = OptionParser(usage="%prog [options] <out.pak> <module.mod>...")
+    parser.add_option("--header", default="protocol/protocol.h",
+                      help="protocol list used to name the modules")
+    parser.add_option("--max", type="int", default=4096,
+                      help="size of the module RAM region")
+    (options, args) = parser.parse_args()
+    if len(args) < 2:
+        parser.error("Need an output file and at least one module")
+
+    names = protocol_names(options.header)
+    entries = []
+    blobs = {}
+    data = bytearray()
+    raw_total = 0
+    header_len = 8 + len(args[1:]) * (NAME_LEN + 8)
+    for filename in args[1:]:
+        with open(filename, "rb") as fh:
+            raw = fh.read()
+        if len(raw) > options.max:
+            sys.exit("ERROR: %s is larger than %d bytes" % (filename, options.max))
+        name = module_name(filename, names)
+        if len(name) >= NAME_LEN:
+            sys.exit("ERROR: Protocol name '%s' is too long" % name)
+        if raw not in blobs:
+            packed = lz4_compress(raw)
+            if len(packed) >= len(raw) or lz4_decompress_in_place(packed, len(raw), options.max) != raw:
+                packed = raw
+            blobs[raw] = (header_len + len(data), len(packed))
+            data += packed
+            raw_total += len(raw)
+        offset, packed_len = blobs[raw]
+        entries.append(struct.pack("<%dsIHH" % NAME_LEN, name.encode(), offset, len(raw), packed_len))
+
+    with open(args[0], "wb") as fh:
+        fh.write(MAGIC + struct.pack("<HH", VERSION, len(entries)))
+        for entry in entries:
+            fh.write(entry)
+        fh.write(data)
+    print("Packed %d protocols (%d modules) into %d bytes (%d uncompressed)"
+          % (len(entries), len(blobs), header_len + len(data), raw_total))
+
+if __name__ == "__main__":
+    main()